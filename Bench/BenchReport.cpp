@@ -0,0 +1,162 @@
+#include "Bench/BenchReport.h"
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <iomanip>
+
+using namespace swbench;
+
+namespace
+{
+    double toSeconds(std::chrono::nanoseconds d)
+    {
+        return std::chrono::duration<double>(d).count();
+    }
+
+    double toMicroseconds(std::chrono::nanoseconds d)
+    {
+        return std::chrono::duration<double, std::micro>(d).count();
+    }
+
+    // The names and the pragma values do not contain control characters.
+    void writeMicroseconds(std::ostream& out, const std::optional<std::chrono::nanoseconds>& d)
+    {
+        if (d)
+        {
+            out << toMicroseconds(*d);
+        }
+        else
+        {
+            out << "null";
+        }
+    }
+
+    void writeJsonString(std::ostream& out, const std::string& s)
+    {
+        out << '"';
+
+        for (const char c : s)
+        {
+            if (c == '"' || c == '\\')
+            {
+                out << '\\';
+            }
+
+            out << c;
+        }
+
+        out << '"';
+    }
+}
+
+std::chrono::nanoseconds LatencyStats::percentile(double p)
+{
+    if (m_durations.empty())
+    {
+        return {};
+    }
+
+    if (!m_sorted)
+    {
+        std::ranges::sort(m_durations);
+
+        m_sorted = true;
+    }
+
+    const size_t rank = static_cast<size_t>(std::ceil(p * m_durations.size()));
+
+    return m_durations[std::clamp<size_t>(rank, 1u, m_durations.size()) - 1];
+}
+
+double BenchResult::operationsPerSecond() const
+{
+    return totalTime.count() == 0 ? 0.0 : operationCount / toSeconds(totalTime);
+}
+
+double BenchResult::rowsPerSecond() const
+{
+    return totalTime.count() == 0 ? 0.0 : rowCount / toSeconds(totalTime);
+}
+
+BenchResult swbench::makeResult(std::string workload, std::string synchronous, std::string journal_mode, LatencyStats& stats, size_t row_count)
+{
+    BenchResult result;
+
+    result.workload = std::move(workload);
+    result.synchronous = std::move(synchronous);
+    result.journalMode = std::move(journal_mode);
+
+    result.operationCount = stats.count();
+    result.rowCount = row_count;
+    result.totalTime = stats.total();
+
+    auto percentile = [&stats](double p, size_t min_count) -> std::optional<std::chrono::nanoseconds>
+    {
+        if (stats.count() < min_count)
+        {
+            return {};
+        }
+
+        return stats.percentile(p);
+    };
+
+    result.p50 = percentile(0.5, 2);
+    result.p99 = percentile(0.99, 100);
+    result.p999 = percentile(0.999, 1000);
+    result.max = stats.percentile(1.0);
+
+    return result;
+}
+
+void BenchReport::writeJson(std::ostream& out) const
+{
+    out << "{\"results\":[";
+
+    bool first = true;
+
+    for (const BenchResult& r : m_results)
+    {
+        if (!first)
+        {
+            out << ",";
+        }
+
+        first = false;
+
+        out << "\n{\"workload\":";
+        writeJsonString(out, r.workload);
+
+        out << ",\"synchronous\":";
+        writeJsonString(out, r.synchronous);
+
+        out << ",\"journal_mode\":";
+        writeJsonString(out, r.journalMode);
+
+        out << std::fixed << std::setprecision(3) <<
+            ",\"operations\":" << r.operationCount << ",\"rows\":" << r.rowCount <<
+            ",\"seconds\":" << toSeconds(r.totalTime) <<
+            ",\"operations_per_second\":" << r.operationsPerSecond() << ",\"rows_per_second\":" << r.rowsPerSecond() <<
+            ",\"p50_us\":";
+        writeMicroseconds(out, r.p50);
+
+        out << ",\"p99_us\":";
+        writeMicroseconds(out, r.p99);
+
+        out << ",\"p999_us\":";
+        writeMicroseconds(out, r.p999);
+
+        out << ",\"max_us\":" << toMicroseconds(r.max) << "}";
+    }
+
+    out << "\n]}\n";
+}
+
+std::string BenchReport::json() const
+{
+    std::ostringstream out;
+
+    writeJson(out);
+
+    return out.str();
+}
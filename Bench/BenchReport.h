@@ -0,0 +1,100 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <vector>
+#include <ostream>
+
+namespace swbench
+{
+    // The durations of the measured operations of a workload.
+    class LatencyStats
+    {
+    public:
+
+        void add(std::chrono::nanoseconds d)
+        {
+            m_durations.push_back(d);
+
+            m_total += d;
+
+            m_sorted = false;
+        }
+
+        size_t count() const
+        {
+            return m_durations.size();
+        }
+
+        std::chrono::nanoseconds total() const
+        {
+            return m_total;
+        }
+
+        // The nearest-rank percentile, p is in (0, 1].
+        std::chrono::nanoseconds percentile(double p);
+
+    private:
+
+        std::vector<std::chrono::nanoseconds> m_durations;
+
+        std::chrono::nanoseconds m_total{};
+
+        bool m_sorted = true;
+    };
+
+    struct BenchResult
+    {
+        std::string workload;
+        std::string synchronous;
+        std::string journalMode;
+
+        // A bulk insert operation inserts multiple rows and a scan reads the whole table.
+        size_t operationCount = 0u;
+        size_t rowCount = 0u;
+
+        // The sum of the measured durations without the warmup.
+        std::chrono::nanoseconds totalTime{};
+
+        // A percentile is reported only if there are enough samples to distinguish it from the maximum,
+        // at least 100 for p99 and 1000 for p999.
+        std::optional<std::chrono::nanoseconds> p50;
+        std::optional<std::chrono::nanoseconds> p99;
+        std::optional<std::chrono::nanoseconds> p999;
+
+        std::chrono::nanoseconds max{};
+
+        double operationsPerSecond() const;
+
+        double rowsPerSecond() const;
+    };
+
+    BenchResult makeResult(std::string workload, std::string synchronous, std::string journal_mode, LatencyStats& stats, size_t row_count);
+
+    class BenchReport
+    {
+    public:
+
+        void add(BenchResult result)
+        {
+            m_results.push_back(std::move(result));
+        }
+
+        const std::vector<BenchResult>& results() const
+        {
+            return m_results;
+        }
+
+        // {"results":[{"workload":"find","synchronous":"FULL","journal_mode":"WAL","operations":1000,...}]},
+        // the percentiles without enough samples are null.
+        void writeJson(std::ostream& out) const;
+
+        std::string json() const;
+
+    private:
+
+        std::vector<BenchResult> m_results;
+    };
+}
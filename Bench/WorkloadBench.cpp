@@ -0,0 +1,374 @@
+#include "Tests/DbContainer.h"
+#include "Tests/ExchangeModel.h"
+#include "Tests/TableHelper.h"
+
+#include "Bench/BenchReport.h"
+
+#include "SQLiteWrapper/Set.h"
+#include "SQLiteWrapper/Bind.h"
+#include "SQLiteWrapper/Get.h"
+
+#include "Awl/Random.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <numeric>
+#include <optional>
+#include <span>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace swtest;
+using namespace swbench;
+using namespace exchange::data;
+
+namespace
+{
+    const std::string dbFileName = "bench.db";
+
+    struct BenchOptions
+    {
+        size_t rowCount;
+        size_t operationCount;
+        size_t warmupCount;
+        size_t batchSize;
+        size_t scanCount;
+        size_t marketCount;
+        size_t repetitionCount;
+    };
+
+    // The measurements of a workload accumulated over the repetitions.
+    struct Workload
+    {
+        LatencyStats stats;
+
+        size_t rowCount = 0u;
+    };
+
+    struct Workloads
+    {
+        Workload bulkInsert;
+        Workload insert;
+        Workload find;
+        Workload update;
+        Workload scan;
+        Workload join;
+        Workload erase;
+    };
+
+    std::vector<std::string> SplitList(const std::string& list)
+    {
+        std::vector<std::string> items;
+
+        std::istringstream in(list);
+
+        std::string item;
+
+        while (std::getline(in, item, ','))
+        {
+            if (!item.empty())
+            {
+                items.push_back(item);
+            }
+        }
+
+        return items;
+    }
+
+    void RemoveDatabase()
+    {
+        for (const char* suffix : { "", "-journal", "-wal", "-shm" })
+        {
+            std::filesystem::remove(dbFileName + suffix);
+        }
+    }
+
+    std::string MakeMarketId(size_t i)
+    {
+        return "M" + std::to_string(i);
+    }
+
+    Order MakeOrder(size_t i, size_t market_count)
+    {
+        const TimePoint now = Clock::now();
+
+        return Order
+        {
+            MakeMarketId(i % market_count),
+            static_cast<OrderId>(i),
+            -1,
+            "client" + std::to_string(i),
+            i % 2 == 0 ? OrderSide::Buy : OrderSide::Sell,
+            OrderType::Limit,
+            OrderStatus::Open,
+            "48456.08"_d,
+            Decimal::zero(),
+            "0.0015"_d,
+            Decimal::zero(),
+            "72.637515"_d,
+            Decimal::zero(),
+            now,
+            now
+        };
+    }
+
+    std::vector<size_t> MakeRandomIndices(size_t count, size_t max)
+    {
+        std::uniform_int_distribution<size_t> dist(0, max - 1);
+
+        std::vector<size_t> indices(count);
+
+        std::ranges::generate(indices, [&dist]() { return dist(awl::random()); });
+
+        return indices;
+    }
+
+    std::string FormatLatency(const std::optional<std::chrono::nanoseconds>& d)
+    {
+        if (!d)
+        {
+            return "n/a";
+        }
+
+        std::ostringstream out;
+
+        out << std::fixed << std::setprecision(1) << std::chrono::duration<double, std::micro>(*d).count() << "us";
+
+        return out.str();
+    }
+
+    // Runs warmup_count operations without measuring them and then count measured operations,
+    // the function takes the index of the operation and returns the number of the rows it processed.
+    template <class Func>
+    void Run(Workload& workload, size_t warmup_count, size_t count, Func&& func)
+    {
+        for (size_t i = 0; i < warmup_count; ++i)
+        {
+            func(i);
+        }
+
+        for (size_t i = warmup_count; i < warmup_count + count; ++i)
+        {
+            const auto start = std::chrono::steady_clock::now();
+
+            const size_t row_count = func(i);
+
+            workload.stats.add(std::chrono::steady_clock::now() - start);
+
+            workload.rowCount += row_count;
+        }
+    }
+
+    void RunWorkloads(const awl::testing::TestContext& context, const BenchOptions& options,
+        const std::string& synchronous, const std::string& journal_mode, Workloads& w)
+    {
+        RemoveDatabase();
+
+        auto db = std::make_shared<Database>(dbFileName.c_str(), *context.logger);
+
+        db->exec("PRAGMA journal_mode = " + journal_mode + ";");
+        db->exec("PRAGMA synchronous = " + synchronous + ";");
+
+        auto markets = makeSet(db, "markets", std::make_tuple(&Market::id));
+        auto orders = makeSet(db, "orders", std::make_tuple(&Order::marketId, &Order::id));
+
+        db->tryOutermost([&markets, &options]()
+        {
+            for (size_t i = 0; i < options.marketCount; ++i)
+            {
+                markets.insert(Market{ {}, MakeMarketId(i), {} });
+            }
+        });
+
+        // At least one batch prepares the statements and warms up the cache.
+        const size_t warmup_batch_count = std::max<size_t>(1, options.warmupCount / options.batchSize);
+        const size_t batch_count = options.rowCount / options.batchSize;
+
+        const size_t bulk_row_count = (warmup_batch_count + batch_count) * options.batchSize;
+        const size_t total_count = bulk_row_count + options.warmupCount + options.operationCount;
+
+        std::vector<Order> values;
+
+        values.reserve(total_count);
+
+        for (size_t i = 0; i < total_count; ++i)
+        {
+            values.push_back(MakeOrder(i, options.marketCount));
+        }
+
+        Run(w.bulkInsert, warmup_batch_count, batch_count, [&orders, &values, &options](size_t i)
+        {
+            orders.insertBatch(std::span<const Order>(values.data() + i * options.batchSize, options.batchSize));
+
+            return options.batchSize;
+        });
+
+        // Every insert is a separate transaction.
+        Run(w.insert, options.warmupCount, options.operationCount, [&orders, &values, bulk_row_count](size_t i)
+        {
+            orders.insert(values[bulk_row_count + i]);
+
+            return size_t(1);
+        });
+
+        const size_t op_count = options.warmupCount + options.operationCount;
+
+        const std::vector<size_t> find_indices = MakeRandomIndices(op_count, total_count);
+
+        Run(w.find, options.warmupCount, options.operationCount, [&orders, &values, &find_indices](size_t i)
+        {
+            const Order& expected = values[find_indices[i]];
+
+            Order order;
+
+            if (!orders.find(std::make_tuple(expected.marketId, expected.id), order))
+            {
+                throw std::runtime_error("An order has not been found.");
+            }
+
+            return size_t(1);
+        });
+
+        const std::vector<size_t> update_indices = MakeRandomIndices(op_count, total_count);
+
+        Run(w.update, options.warmupCount, options.operationCount, [&orders, &values, &update_indices](size_t i)
+        {
+            Order order = values[update_indices[i]];
+
+            order.filled = order.amount;
+            order.status = OrderStatus::Closed;
+
+            orders.update(order);
+
+            return size_t(1);
+        });
+
+        Run(w.scan, 1, options.scanCount, [&orders](size_t)
+        {
+            size_t row_count = 0;
+
+            for (const Order& order : orders)
+            {
+                static_cast<void>(order);
+
+                ++row_count;
+            }
+
+            return row_count;
+        });
+
+        Statement join_statement(*db,
+            "SELECT orders.id, orders.amount, markets.precision_price FROM orders JOIN markets ON markets.id = orders.marketId "
+            "WHERE markets.id = ?1;");
+
+        const std::vector<size_t> join_indices = MakeRandomIndices(op_count, options.marketCount);
+
+        Run(w.join, options.warmupCount, options.operationCount, [&join_statement, &join_indices](size_t i)
+        {
+            sqlite::bind(join_statement, 0, MakeMarketId(join_indices[i]));
+
+            size_t row_count = 0;
+
+            while (join_statement.Next())
+            {
+                OrderId id;
+
+                sqlite::get(join_statement, 0, id);
+
+                ++row_count;
+            }
+
+            join_statement.reset();
+
+            return row_count;
+        });
+
+        join_statement.close();
+
+        // Each order is deleted once.
+        std::vector<size_t> erase_indices(total_count);
+
+        std::iota(erase_indices.begin(), erase_indices.end(), size_t(0));
+
+        std::ranges::shuffle(erase_indices, awl::random());
+
+        Run(w.erase, options.warmupCount, std::min(options.operationCount, total_count - options.warmupCount),
+            [&orders, &values, &erase_indices](size_t i)
+        {
+            const Order& order = values[erase_indices[i]];
+
+            orders.deleteElement(std::make_tuple(order.marketId, order.id));
+
+            return size_t(1);
+        });
+    }
+}
+
+// Measures the typical operations on the orders of ExchangeModel.h with all the combinations of
+// synchronous and journal_mode pragmas and writes the throughput and the latency percentiles to a JSON file.
+//--output all --filter Workloads_Benchmark --repetition_count 5 --synchronous OFF,NORMAL,FULL --journal_mode DELETE,TRUNCATE,WAL --json_file bench.json
+AWL_BENCHMARK(Workloads)
+{
+    AWL_ATTRIBUTE(size_t, row_count, 10000);
+    AWL_ATTRIBUTE(size_t, operation_count, 1000);
+    AWL_ATTRIBUTE(size_t, warmup_count, 100);
+    AWL_ATTRIBUTE(size_t, batch_size, 1000);
+    AWL_ATTRIBUTE(size_t, scan_count, 10);
+    AWL_ATTRIBUTE(size_t, market_count, 100);
+    AWL_ATTRIBUTE(size_t, repetition_count, 3);
+    AWL_ATTRIBUTE(awl::String, synchronous, _T("OFF,NORMAL,FULL"));
+    AWL_ATTRIBUTE(awl::String, journal_mode, _T("DELETE,WAL"));
+    AWL_ATTRIBUTE(awl::String, json_file, _T("bench.json"));
+
+    if (batch_size == 0 || market_count == 0 || row_count < batch_size)
+    {
+        throw std::invalid_argument("The batch size and the market count should not be zero, the row count should not be less than the batch size.");
+    }
+
+    const BenchOptions options{ row_count, operation_count, warmup_count, batch_size, scan_count, market_count, repetition_count };
+
+    BenchReport report;
+
+    for (const std::string& sync_mode : SplitList(awl::toAString(synchronous)))
+    {
+        for (const std::string& journal : SplitList(awl::toAString(journal_mode)))
+        {
+            Workloads w;
+
+            for (size_t i = 0; i < options.repetitionCount; ++i)
+            {
+                RunWorkloads(context, options, sync_mode, journal, w);
+            }
+
+            RemoveDatabase();
+
+            for (auto [name, p_workload] : { std::make_pair("bulk_insert", &w.bulkInsert), std::make_pair("insert", &w.insert),
+                std::make_pair("find", &w.find), std::make_pair("update", &w.update), std::make_pair("scan", &w.scan),
+                std::make_pair("join", &w.join), std::make_pair("delete", &w.erase) })
+            {
+                BenchResult result = makeResult(name, sync_mode, journal, p_workload->stats, p_workload->rowCount);
+
+                context.logger->debug(awl::format() << std::fixed << std::setprecision(1) <<
+                    std::string(name) << _T(" synchronous=") << sync_mode << _T(" journal_mode=") << journal <<
+                    _T(": ") << result.operationCount << _T(" samples, ") <<
+                    result.operationsPerSecond() << _T(" op/s, ") << result.rowsPerSecond() << _T(" rows/s, p50: ") <<
+                    FormatLatency(result.p50) << _T(", p99: ") << FormatLatency(result.p99) << _T(", p999: ") << FormatLatency(result.p999));
+
+                report.add(std::move(result));
+            }
+        }
+    }
+
+    const std::string file_name = awl::toAString(json_file);
+
+    if (!file_name.empty())
+    {
+        std::ofstream out(file_name);
+
+        report.writeJson(out);
+    }
+}
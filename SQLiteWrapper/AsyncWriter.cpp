@@ -0,0 +1,163 @@
+#include "SQLiteWrapper/AsyncWriter.h"
+
+#include <algorithm>
+
+using namespace sqlite;
+
+namespace
+{
+    // How long the writer sleeps when it waits for more commands within the window.
+    constexpr std::chrono::microseconds maxPollInterval{ 100 };
+}
+
+AsyncWriter::AsyncWriter(std::shared_ptr<Database> db, Clock::duration window, size_t max_batch_size) :
+    m_db(std::move(db)),
+    m_window(window),
+    m_maxBatchSize(std::max(max_batch_size, size_t(1)))
+{
+    m_thread = std::thread([this]() { run(); });
+}
+
+void AsyncWriter::stop()
+{
+    if (m_thread.joinable())
+    {
+        push(&m_stopCommand);
+
+        m_thread.join();
+    }
+}
+
+void AsyncWriter::push(Command* p_command)
+{
+    Command* p_head = m_head.load(std::memory_order_relaxed);
+
+    do
+    {
+        p_command->next = p_head;
+    }
+    while (!m_head.compare_exchange_weak(p_head, p_command, std::memory_order_release, std::memory_order_relaxed));
+
+    // Wake up the writer if it waits for the first command.
+    if (p_head == nullptr)
+    {
+        m_head.notify_one();
+    }
+}
+
+void AsyncWriter::takeAll()
+{
+    Command* p_command = m_head.exchange(nullptr, std::memory_order_acquire);
+
+    const size_t first_index = m_batch.size();
+
+    for (; p_command != nullptr; p_command = p_command->next)
+    {
+        m_batch.push_back(p_command);
+    }
+
+    std::reverse(m_batch.begin() + first_index, m_batch.end());
+
+    m_stopping = m_stopping || std::find(m_batch.begin() + first_index, m_batch.end(), &m_stopCommand) != m_batch.end();
+}
+
+void AsyncWriter::run()
+{
+    while (!m_stopping)
+    {
+        m_head.wait(nullptr, std::memory_order_acquire);
+
+        collectBatch();
+
+        commitBatch();
+    }
+}
+
+void AsyncWriter::collectBatch()
+{
+    const Clock::time_point deadline = Clock::now() + m_window;
+
+    takeAll();
+
+    while (!m_stopping && m_batch.size() < m_maxBatchSize)
+    {
+        const Clock::time_point now = Clock::now();
+
+        if (now >= deadline)
+        {
+            break;
+        }
+
+        if (m_head.load(std::memory_order_relaxed) == nullptr)
+        {
+            std::this_thread::sleep_for(std::min<Clock::duration>(deadline - now, maxPollInterval));
+        }
+
+        takeAll();
+    }
+}
+
+void AsyncWriter::commitBatch()
+{
+    std::erase(m_batch, &m_stopCommand);
+
+    if (m_batch.empty())
+    {
+        return;
+    }
+
+    m_errors.assign(m_batch.size(), nullptr);
+
+    std::exception_ptr commit_error;
+
+    try
+    {
+        m_db->beginTransaction();
+
+        for (size_t i = 0; i < m_batch.size(); ++i)
+        {
+            try
+            {
+                Command* p_command = m_batch[i];
+
+                m_db->tryRun([this, p_command]() { p_command->execute(*m_db); });
+            }
+            catch (...)
+            {
+                m_errors[i] = std::current_exception();
+            }
+        }
+
+        m_db->commit();
+
+        m_commitCount.fetch_add(1, std::memory_order_relaxed);
+    }
+    catch (...)
+    {
+        commit_error = std::current_exception();
+
+        // The transaction is not active if BEGIN failed or COMMIT rolled it back.
+        if (!m_db->isAutocommit())
+        {
+            m_db->execRaw("ROLLBACK;");
+        }
+    }
+
+    for (size_t i = 0; i < m_batch.size(); ++i)
+    {
+        Command* p_command = m_batch[i];
+
+        try
+        {
+            p_command->complete(m_errors[i] ? m_errors[i] : commit_error);
+        }
+        catch (const std::exception& e)
+        {
+            m_db->logger().error(awl::format() << "AsyncWriter callback has thrown an exception: " << e.what());
+        }
+
+        delete p_command;
+    }
+
+    m_batch.clear();
+}
@@ -0,0 +1,207 @@
+#pragma once
+
+#include "SQLiteWrapper/Database.h"
+#include "SQLiteWrapper/Set.h"
+
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <future>
+#include <functional>
+#include <exception>
+#include <chrono>
+#include <vector>
+#include <tuple>
+#include <utility>
+
+namespace sqlite
+{
+    // Executes the mutations in a dedicated thread and commits them in groups,
+    // so a thread posting a mutation does not wait for fsync.
+    // The thread opens a transaction when the first command arrives and commits it when the window elapses
+    // or when maxBatchSize commands are collected, then the futures and callbacks of the commands are resolved.
+    // Each command runs in its own savepoint, so a failed command does not roll back the others.
+    // After a Set is passed to the writer it should not be used by other threads until the writer is stopped.
+    class AsyncWriter
+    {
+    public:
+
+        using Clock = std::chrono::steady_clock;
+
+        // Receives nullptr if the command has been committed.
+        using Callback = std::function<void(std::exception_ptr)>;
+
+        static constexpr size_t defaultMaxBatchSize = 1000;
+
+        AsyncWriter(std::shared_ptr<Database> db, Clock::duration window = {}, size_t max_batch_size = defaultMaxBatchSize);
+
+        AsyncWriter(const AsyncWriter&) = delete;
+
+        AsyncWriter& operator = (const AsyncWriter&) = delete;
+
+        ~AsyncWriter()
+        {
+            stop();
+        }
+
+        // Commits the posted commands and stops the thread, the commands should not be posted after that.
+        void stop();
+
+        // The function is called in the writer thread with the database as the argument.
+        template <class Func>
+        void post(Func func, Callback callback)
+        {
+            push(new FuncCommand<Func>(std::move(func), std::move(callback)));
+        }
+
+        template <class Func>
+        std::future<void> post(Func func)
+        {
+            auto p_promise = std::make_shared<std::promise<void>>();
+
+            std::future<void> future = p_promise->get_future();
+
+            post(std::move(func), [p_promise](std::exception_ptr error)
+            {
+                if (error)
+                {
+                    p_promise->set_exception(error);
+                }
+                else
+                {
+                    p_promise->set_value();
+                }
+            });
+
+            return future;
+        }
+
+        template <class Value, class... Keys>
+        std::future<void> insert(Set<Value, Keys...>& set, Value val)
+        {
+            return post([&set, val = std::move(val)](Database&) { set.insert(val); });
+        }
+
+        template <class Value, class... Keys>
+        void insert(Set<Value, Keys...>& set, Value val, Callback callback)
+        {
+            post([&set, val = std::move(val)](Database&) { set.insert(val); }, std::move(callback));
+        }
+
+        template <class Value, class... Keys>
+        std::future<void> update(Set<Value, Keys...>& set, Value val)
+        {
+            return post([&set, val = std::move(val)](Database&) { set.update(val); });
+        }
+
+        template <class Value, class... Keys>
+        void update(Set<Value, Keys...>& set, Value val, Callback callback)
+        {
+            post([&set, val = std::move(val)](Database&) { set.update(val); }, std::move(callback));
+        }
+
+        template <class Value, class... Keys>
+        std::future<void> deleteElement(Set<Value, Keys...>& set, std::tuple<Keys...> ids)
+        {
+            return post([&set, ids = std::move(ids)](Database&) { set.deleteElement(ids); });
+        }
+
+        template <class Value, class... Keys>
+        void deleteElement(Set<Value, Keys...>& set, std::tuple<Keys...> ids, Callback callback)
+        {
+            post([&set, ids = std::move(ids)](Database&) { set.deleteElement(ids); }, std::move(callback));
+        }
+
+        // The number of the committed transactions.
+        size_t commitCount() const
+        {
+            return m_commitCount.load(std::memory_order_relaxed);
+        }
+
+    private:
+
+        class Command
+        {
+        public:
+
+            virtual ~Command() = default;
+
+            virtual void execute(Database& db) = 0;
+
+            virtual void complete(std::exception_ptr error) = 0;
+
+            Command* next = nullptr;
+        };
+
+        template <class Func>
+        class FuncCommand : public Command
+        {
+        public:
+
+            FuncCommand(Func func, Callback callback) : m_func(std::move(func)), m_callback(std::move(callback)) {}
+
+            void execute(Database& db) override
+            {
+                m_func(db);
+            }
+
+            void complete(std::exception_ptr error) override
+            {
+                if (m_callback)
+                {
+                    m_callback(error);
+                }
+            }
+
+        private:
+
+            Func m_func;
+
+            Callback m_callback;
+        };
+
+        // Wakes up the thread and makes it exit after the commands posted before.
+        class StopCommand : public Command
+        {
+        public:
+
+            void execute(Database&) override {}
+
+            void complete(std::exception_ptr) override {}
+        };
+
+        // Lock-free multiple producer single consumer queue: the producers push to the stack
+        // and the consumer takes the whole stack at once and reverses it.
+        void push(Command* p_command);
+
+        // Appends the pushed commands in the order they were pushed.
+        void takeAll();
+
+        void run();
+
+        void collectBatch();
+
+        void commitBatch();
+
+        const std::shared_ptr<Database> m_db;
+
+        const Clock::duration m_window;
+
+        const size_t m_maxBatchSize;
+
+        std::atomic<Command*> m_head = nullptr;
+
+        std::atomic<size_t> m_commitCount = 0;
+
+        StopCommand m_stopCommand;
+
+        bool m_stopping = false;
+
+        // Used by the writer thread only.
+        std::vector<Command*> m_batch;
+
+        std::vector<std::exception_ptr> m_errors;
+
+        std::thread m_thread;
+    };
+}
@@ -12,7 +12,8 @@ namespace sqlite
     public:
 
         AutoincrementSet(const std::shared_ptr<Database>& db, std::string table_name, Int Value::* id_ptr) :
-            m_storage(db, std::move(table_name), std::make_tuple(id_ptr))
+            m_storage(db, std::move(table_name), std::make_tuple(id_ptr)),
+            valueBindPlan(m_storage.valueFilter())
         {
             insertWithoutIdStatement = m_storage.makeStatement("autoinsert", buildParameterizedInsertQuery<Value>(m_storage.tableName, m_storage.valueFilter()));
         }
@@ -42,7 +43,7 @@ namespace sqlite
 
         void insert(Value& val)
         {
-            m_storage.bindValue(insertWithoutIdStatement, val, m_storage.valueFilter());
+            valueBindPlan.bind(insertWithoutIdStatement, val);
 
             insertWithoutIdStatement.exec();
 
@@ -52,7 +53,7 @@ namespace sqlite
         // It may still violate some constraint like UNIQUE index on other columns.
         bool tryinsert(Value& val)
         {
-            m_storage.bindValue(insertWithoutIdStatement, val, m_storage.valueFilter());
+            valueBindPlan.bind(insertWithoutIdStatement, val);
 
             const bool success = insertWithoutIdStatement.exec();
 
@@ -90,9 +91,9 @@ namespace sqlite
         }
 
         template <class... Field>
-        Updater<Value> createUpdater(std::tuple<Field Value::*...> field_ptrs) const
+        Updater<Value> createUpdater(std::tuple<Field...> field_paths) const
         {
-            return m_storage.createUpdater(field_ptrs);
+            return m_storage.createUpdater(field_paths);
         }
 
         void tryDeleteRecord(Int id)
@@ -127,6 +128,9 @@ namespace sqlite
 
         Set<Value, Int> m_storage;
 
+        // Binds all the fields except the id.
+        BindPlan<Value> valueBindPlan;
+
         Statement insertWithoutIdStatement;
     };
 }
@@ -12,6 +12,8 @@
 #include <limits>
 #include <chrono>
 #include <optional>
+#include <string>
+#include <string_view>
 
 namespace sqlite
 {
@@ -78,7 +80,12 @@ namespace sqlite
 
     inline void bind(Statement & st, size_t col, const std::string & val)
     {
-        st.bindText(col, val.c_str());
+        st.bindText(col, std::string_view(val));
+    }
+
+    inline void bind(Statement & st, size_t col, std::string_view val, Lifetime lifetime = Lifetime::Static)
+    {
+        st.bindText(col, val, lifetime);
     }
 
     inline void bind(Statement & st, size_t col, const char * val)
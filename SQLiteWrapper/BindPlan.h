@@ -0,0 +1,153 @@
+#pragma once
+
+#include "SQLiteWrapper/Statement.h"
+#include "SQLiteWrapper/Helpers.h"
+#include "SQLiteWrapper/IndexFilter.h"
+#include "SQLiteWrapper/Bind.h"
+
+#include <array>
+#include <vector>
+#include <tuple>
+#include <utility>
+#include <type_traits>
+
+namespace sqlite::helpers
+{
+    template <class T>
+    constexpr size_t columnCount()
+    {
+        if constexpr (awl::is_reflectable_v<T>)
+        {
+            return fieldCount<T>();
+        }
+        else
+        {
+            return 1;
+        }
+    }
+
+    // The index of the top level field containing the column and the index of the column in that field.
+    template <class T, size_t column_index>
+    constexpr std::pair<size_t, size_t> locateColumn()
+    {
+        using Tie = typename awl::tuplizable_traits<T>::Tie;
+
+        std::pair<size_t, size_t> location = { noIndex, noIndex };
+
+        size_t start_index = 0;
+
+        forEachTF<Tie>([&location, &start_index](auto fieldIndex)
+        {
+            using FieldType = std::remove_cvref_t<std::tuple_element_t<fieldIndex, Tie>>;
+
+            const size_t count = columnCount<FieldType>();
+
+            if (column_index >= start_index && column_index < start_index + count)
+            {
+                location = { fieldIndex, column_index - start_index };
+            }
+
+            start_index += count;
+        });
+
+        return location;
+    }
+
+    // Returns the field of a column (possibly in a nested structure) without iterating over the other fields.
+    template <size_t column_index, class T>
+    decltype(auto) columnValue(T& val)
+    {
+        constexpr std::pair<size_t, size_t> location = locateColumn<std::remove_const_t<T>, column_index>();
+
+        static_assert(location.first != noIndex, "Wrong column index.");
+
+        auto& field = std::get<location.first>(val.as_tuple());
+
+        using FieldType = std::remove_cvref_t<decltype(field)>;
+
+        if constexpr (awl::is_reflectable_v<FieldType>)
+        {
+            return columnValue<location.second>(field);
+        }
+        else
+        {
+            return (field);
+        }
+    }
+
+    template <class Struct>
+    using BindFunc = void (*)(Statement& stmt, size_t col, const Struct& val);
+
+    template <class Struct, size_t column_index>
+    void bindColumn(Statement& stmt, size_t col, const Struct& val)
+    {
+        // Statement argument makes ADL find the overloads declared after this header.
+        bind(stmt, col, columnValue<column_index>(val));
+    }
+
+    template <class Struct, size_t... column_index>
+    std::array<BindFunc<Struct>, sizeof...(column_index)> makeColumnBinders(std::index_sequence<column_index...>)
+    {
+        return { &bindColumn<Struct, column_index>... };
+    }
+
+    // The binders of all the columns of a structure indexed by the column.
+    template <class Struct>
+    BindFunc<Struct> columnBinder(size_t column_index)
+    {
+        static const std::array<BindFunc<Struct>, fieldCount<Struct>()> binders =
+            makeColumnBinders<Struct>(std::make_index_sequence<fieldCount<Struct>()>());
+
+        return binders[column_index];
+    }
+}
+
+namespace sqlite
+{
+    // A flat list of the columns to bind, it is built once, so binding a value does not iterate
+    // over all its fields and does not check if a field is in the filter.
+    template <class Struct>
+    class BindPlan
+    {
+    public:
+
+        BindPlan() = default;
+
+        explicit BindPlan(const IndexFilter& filter)
+        {
+            m_steps.reserve(filter.size());
+
+            for (size_t column_index : filter)
+            {
+                m_steps.push_back(Step{ column_index, helpers::columnBinder<Struct>(column_index) });
+            }
+        }
+
+        // The fields are bound to the parameters with the same indices as the columns.
+        void bind(Statement& stmt, const Struct& val) const
+        {
+            for (const Step& step : m_steps)
+            {
+                step.func(stmt, step.column, val);
+            }
+        }
+
+        size_t size() const
+        {
+            return m_steps.size();
+        }
+
+    private:
+
+        using BindFunc = helpers::BindFunc<Struct>;
+
+        struct Step
+        {
+            size_t column;
+
+            BindFunc func;
+        };
+
+        std::vector<Step> m_steps;
+    };
+}
@@ -0,0 +1,206 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <vector>
+#include <utility>
+#include <type_traits>
+#include <algorithm>
+#include <cassert>
+
+namespace sqlite
+{
+    // Allocates the objects one after another and destroys them all at once in reset().
+    // When the current block is full a new block twice as large is allocated,
+    // reset() merges the blocks, so after a few iterations the arena does not allocate at all.
+    class BumpArena
+    {
+    public:
+
+        static constexpr std::size_t defaultCapacity = 256u;
+
+        explicit BumpArena(std::size_t capacity = defaultCapacity) : m_initialCapacity(std::max(capacity, std::size_t(1))) {}
+
+        BumpArena(const BumpArena&) = delete;
+
+        BumpArena& operator = (const BumpArena&) = delete;
+
+        BumpArena(BumpArena&& other) noexcept :
+            m_blocks(std::move(other.m_blocks)),
+            m_offset(other.m_offset),
+            m_destructors(other.m_destructors),
+            m_initialCapacity(other.m_initialCapacity)
+        {
+            other.m_blocks.clear();
+            other.m_offset = 0u;
+            other.m_destructors = nullptr;
+        }
+
+        BumpArena& operator = (BumpArena&& other) noexcept
+        {
+            reset();
+
+            m_blocks = std::move(other.m_blocks);
+            m_offset = other.m_offset;
+            m_destructors = other.m_destructors;
+            m_initialCapacity = other.m_initialCapacity;
+
+            other.m_blocks.clear();
+            other.m_offset = 0u;
+            other.m_destructors = nullptr;
+
+            return *this;
+        }
+
+        ~BumpArena()
+        {
+            destroyObjects();
+        }
+
+        // The object lives until reset() is called.
+        template <class T, class... Args>
+        T& make(Args&&... args)
+        {
+            if constexpr (std::is_trivially_destructible_v<T>)
+            {
+                return *new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+            }
+            else
+            {
+                // Allocate the record first, so the constructed object always has its destructor registered.
+                void* p_record = allocate(sizeof(Destructor), alignof(Destructor));
+
+                T* p_obj = new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+
+                m_destructors = new (p_record) Destructor{ &destroy<T>, p_obj, m_destructors };
+
+                return *p_obj;
+            }
+        }
+
+        void reset()
+        {
+            destroyObjects();
+
+            if (m_blocks.size() > 1u)
+            {
+                std::size_t capacity = 0u;
+
+                for (const Block& block : m_blocks)
+                {
+                    capacity += block.size;
+                }
+
+                m_blocks.clear();
+
+                addBlock(capacity);
+            }
+
+            m_offset = 0u;
+        }
+
+        // The total size of the allocated blocks.
+        std::size_t capacity() const
+        {
+            std::size_t capacity = 0u;
+
+            for (const Block& block : m_blocks)
+            {
+                capacity += block.size;
+            }
+
+            return capacity;
+        }
+
+    private:
+
+        struct Block
+        {
+            std::unique_ptr<std::byte[]> data;
+            std::size_t size;
+        };
+
+        struct Destructor
+        {
+            void (*func)(void*);
+            void* obj;
+            Destructor* next;
+        };
+
+        template <class T>
+        static void destroy(void* p)
+        {
+            static_cast<T*>(p)->~T();
+        }
+
+        void* allocate(std::size_t size, std::size_t alignment)
+        {
+            if (!m_blocks.empty())
+            {
+                if (void* p = allocateInBlock(m_blocks.back(), size, alignment))
+                {
+                    return p;
+                }
+            }
+
+            const std::size_t last_size = m_blocks.empty() ? m_initialCapacity / 2u : m_blocks.back().size;
+
+            addBlock(std::max(last_size * 2u, size + alignment));
+
+            m_offset = 0u;
+
+            void* p = allocateInBlock(m_blocks.back(), size, alignment);
+
+            assert(p != nullptr);
+
+            return p;
+        }
+
+        void* allocateInBlock(Block& block, std::size_t size, std::size_t alignment)
+        {
+            const std::uintptr_t base = reinterpret_cast<std::uintptr_t>(block.data.get());
+
+            const std::uintptr_t aligned = (base + m_offset + alignment - 1u) & ~(static_cast<std::uintptr_t>(alignment) - 1u);
+
+            const std::size_t offset = static_cast<std::size_t>(aligned - base);
+
+            if (offset + size > block.size)
+            {
+                return nullptr;
+            }
+
+            m_offset = offset + size;
+
+            return block.data.get() + offset;
+        }
+
+        void addBlock(std::size_t size)
+        {
+            m_blocks.push_back(Block{ std::unique_ptr<std::byte[]>(new std::byte[size]), size });
+        }
+
+        void destroyObjects()
+        {
+            // In the reverse order of construction.
+            while (m_destructors != nullptr)
+            {
+                Destructor* p = m_destructors;
+
+                m_destructors = p->next;
+
+                p->func(p->obj);
+            }
+        }
+
+        std::vector<Block> m_blocks;
+
+        // The offset in the last block.
+        std::size_t m_offset = 0u;
+
+        Destructor* m_destructors = nullptr;
+
+        std::size_t m_initialCapacity;
+    };
+}
@@ -0,0 +1,142 @@
+#pragma once
+
+#include "SQLiteWrapper/Statement.h"
+#include "SQLiteWrapper/Get.h"
+#include "SQLiteWrapper/BindPlan.h"
+#include "SQLiteWrapper/HeterogeneousIterator.h"
+
+#include <vector>
+#include <tuple>
+#include <span>
+#include <utility>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+
+namespace sqlite::helpers
+{
+    // The type of a column (a field of a nested structure is a separate column).
+    template <class Struct, size_t column_index>
+    using ColumnType = std::remove_cvref_t<decltype(columnValue<column_index>(std::declval<Struct&>()))>;
+
+    // std::vector<bool> does not have contiguous elements.
+    template <class T>
+    using ColumnElementType = std::conditional_t<std::is_same_v<T, bool>, uint8_t, T>;
+}
+
+namespace sqlite
+{
+    // Reads the rows of a statement selecting all the columns of a structure batch by batch
+    // into a vector per column, so the values of a column are contiguous.
+    // The vectors are sized by the batch size once and reused for all the batches,
+    // so the strings keep their capacity. The columns should not be views (std::string_view, std::span),
+    // because they are invalidated when the statement is stepped.
+    template <class Struct>
+    class ColumnBatchReader
+    {
+    private:
+
+        template <size_t column_index>
+        using Element = helpers::ColumnElementType<helpers::ColumnType<Struct, column_index>>;
+
+        template <size_t... column_index>
+        static auto makeColumns(std::index_sequence<column_index...>) -> std::tuple<std::vector<Element<column_index>>...>;
+
+    public:
+
+        static constexpr size_t columnCount = helpers::fieldCount<Struct>();
+
+        static constexpr size_t defaultBatchSize = 1024;
+
+        using Columns = decltype(makeColumns(std::make_index_sequence<columnCount>()));
+
+        ColumnBatchReader(Statement& s, size_t batch_size = defaultBatchSize) : m_i(s)
+        {
+            setBatchSize(batch_size);
+        }
+
+        ColumnBatchReader(const ColumnBatchReader&) = delete;
+
+        ColumnBatchReader& operator = (const ColumnBatchReader&) = delete;
+
+        ColumnBatchReader(ColumnBatchReader&& other) = default;
+
+        ColumnBatchReader& operator = (ColumnBatchReader&& other) = default;
+
+        // Reads up to the batch size rows, returns the number of rows read, it is zero at the end.
+        size_t next()
+        {
+            m_size = 0;
+
+            while (!m_end && m_size < m_batchSize)
+            {
+                if (m_i.Next())
+                {
+                    readRow(m_size, std::make_index_sequence<columnCount>());
+
+                    ++m_size;
+                }
+                else
+                {
+                    m_end = true;
+                }
+            }
+
+            return m_size;
+        }
+
+        // The number of rows in the current batch.
+        size_t size() const
+        {
+            return m_size;
+        }
+
+        // The values of a column in the current batch, the columns are indexed as in forEachColumn.
+        template <size_t column_index>
+        std::span<const Element<column_index>> column() const
+        {
+            return std::span<const Element<column_index>>(std::get<column_index>(m_columns).data(), m_size);
+        }
+
+        size_t batchSize() const
+        {
+            return m_batchSize;
+        }
+
+        // Takes effect on the next batch.
+        void setBatchSize(size_t batch_size)
+        {
+            if (batch_size == 0)
+            {
+                throw std::invalid_argument("Batch size should not be zero.");
+            }
+
+            m_batchSize = batch_size;
+
+            std::apply([batch_size](auto&... column)
+            {
+                (column.resize(batch_size), ...);
+            }, m_columns);
+
+            m_size = 0;
+        }
+
+    private:
+
+        template <size_t... column_index>
+        void readRow(size_t row_index, std::index_sequence<column_index...>)
+        {
+            (m_i.get(column_index, std::get<column_index>(m_columns)[row_index]), ...);
+        }
+
+        HeterogeneousIterator m_i;
+
+        Columns m_columns;
+
+        size_t m_batchSize = defaultBatchSize;
+
+        size_t m_size = 0;
+
+        bool m_end = false;
+    };
+}
@@ -0,0 +1,127 @@
+#include "SQLiteWrapper/ConnectionPool.h"
+
+#include <cassert>
+
+using namespace sqlite;
+
+const std::shared_ptr<Database>& ConnectionLease::database() const
+{
+    assert(m_pool != nullptr);
+
+    return m_pool->m_connections[m_index].db;
+}
+
+void ConnectionLease::release()
+{
+    if (m_pool != nullptr)
+    {
+        m_pool->release(m_index);
+
+        m_pool = nullptr;
+    }
+}
+
+ConnectionPool::ConnectionPool(const std::string& file_name, std::size_t reader_count, awl::Logger& logger, int busy_timeout)
+{
+    m_connections.reserve(reader_count + 1u);
+
+    // The writer creates the file and switches it to WAL mode before the readers are opened.
+    {
+        auto writer = std::make_shared<Database>(file_name.c_str(), SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_NOMUTEX, logger);
+
+        writer->setBusyTimeout(busy_timeout);
+
+        writer->exec("PRAGMA journal_mode = WAL;");
+
+        m_connections.push_back(Connection{ std::move(writer) });
+    }
+
+    for (std::size_t i = 0; i < reader_count; ++i)
+    {
+        auto reader = std::make_shared<Database>(file_name.c_str(), SQLITE_OPEN_READONLY | SQLITE_OPEN_NOMUTEX, logger);
+
+        reader->setBusyTimeout(busy_timeout);
+
+        m_connections.push_back(Connection{ std::move(reader) });
+    }
+}
+
+ConnectionPool::~ConnectionPool()
+{
+    for (Connection& connection : m_connections)
+    {
+        assert(!connection.busy);
+
+        // Sets created on the connection can still hold it.
+        connection.db->close();
+    }
+}
+
+ConnectionLease ConnectionPool::acquire(std::size_t first, std::size_t last)
+{
+    if (first == last)
+    {
+        throw SQLiteException("The connection pool has no connections of the requested type.");
+    }
+
+    std::unique_lock lock(m_mutex);
+
+    std::size_t found_index = last;
+
+    m_released.wait(lock, [this, first, last, &found_index]()
+    {
+        found_index = findFree(first, last);
+
+        return found_index != last;
+    });
+
+    m_connections[found_index].busy = true;
+
+    return ConnectionLease(*this, found_index);
+}
+
+ConnectionLease ConnectionPool::tryAcquireReader()
+{
+    const std::size_t first = writerIndex + 1u;
+    const std::size_t last = m_connections.size();
+
+    std::lock_guard lock(m_mutex);
+
+    const std::size_t found_index = findFree(first, last);
+
+    if (found_index == last)
+    {
+        return ConnectionLease();
+    }
+
+    m_connections[found_index].busy = true;
+
+    return ConnectionLease(*this, found_index);
+}
+
+std::size_t ConnectionPool::findFree(std::size_t first, std::size_t last) const
+{
+    for (std::size_t i = first; i < last; ++i)
+    {
+        if (!m_connections[i].busy)
+        {
+            return i;
+        }
+    }
+
+    return last;
+}
+
+void ConnectionPool::release(std::size_t index)
+{
+    {
+        std::lock_guard lock(m_mutex);
+
+        assert(m_connections[index].busy);
+
+        m_connections[index].busy = false;
+    }
+
+    // The writer and the readers wait on the same condition.
+    m_released.notify_all();
+}
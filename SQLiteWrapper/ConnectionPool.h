@@ -0,0 +1,148 @@
+#pragma once
+
+#include "SQLiteWrapper/Database.h"
+
+#include "Awl/Logger.h"
+
+#include <memory>
+#include <vector>
+#include <string>
+#include <mutex>
+#include <condition_variable>
+
+namespace sqlite
+{
+    class ConnectionPool;
+
+    // Gives a thread exclusive access to a pooled connection and returns it to the pool in the destructor.
+    // A Set created on the connection should not outlive the lease, but the next Set created on the same
+    // connection takes its statements from the connection statement cache.
+    class ConnectionLease
+    {
+    public:
+
+        ConnectionLease() = default;
+
+        ConnectionLease(const ConnectionLease&) = delete;
+
+        ConnectionLease& operator = (const ConnectionLease&) = delete;
+
+        ConnectionLease(ConnectionLease&& other) noexcept :
+            m_pool(other.m_pool),
+            m_index(other.m_index)
+        {
+            other.m_pool = nullptr;
+        }
+
+        ConnectionLease& operator = (ConnectionLease&& other) noexcept
+        {
+            release();
+
+            m_pool = other.m_pool;
+            m_index = other.m_index;
+
+            other.m_pool = nullptr;
+
+            return *this;
+        }
+
+        ~ConnectionLease()
+        {
+            release();
+        }
+
+        const std::shared_ptr<Database>& database() const;
+
+        Database& operator* () const
+        {
+            return *database();
+        }
+
+        Database* operator-> () const
+        {
+            return database().get();
+        }
+
+        // A default constructed or released lease does not hold a connection.
+        bool acquired() const
+        {
+            return m_pool != nullptr;
+        }
+
+        void release();
+
+    private:
+
+        ConnectionLease(ConnectionPool& pool, std::size_t index) : m_pool(&pool), m_index(index) {}
+
+        ConnectionPool* m_pool = nullptr;
+
+        std::size_t m_index = 0u;
+
+        friend ConnectionPool;
+    };
+
+    // One writer and reader_count read-only connections to the same database file in WAL mode,
+    // so the readers do not block each other and are not blocked by the writer.
+    // The connections are opened with SQLITE_OPEN_NOMUTEX, because a connection is used by one thread at a time.
+    class ConnectionPool
+    {
+    public:
+
+        static constexpr int defaultBusyTimeout = 5000;
+
+        ConnectionPool(const std::string& file_name, std::size_t reader_count, awl::Logger& logger, int busy_timeout = defaultBusyTimeout);
+
+        ConnectionPool(const ConnectionPool&) = delete;
+
+        ConnectionPool& operator = (const ConnectionPool&) = delete;
+
+        ~ConnectionPool();
+
+        // Blocks until the writer is released by another thread.
+        ConnectionLease acquireWriter()
+        {
+            return acquire(writerIndex, writerIndex + 1u);
+        }
+
+        // Blocks until some reader is released by another thread.
+        ConnectionLease acquireReader()
+        {
+            return acquire(writerIndex + 1u, m_connections.size());
+        }
+
+        // Returns a lease that does not hold a connection if all the readers are busy.
+        ConnectionLease tryAcquireReader();
+
+        std::size_t readerCount() const
+        {
+            return m_connections.size() - 1u;
+        }
+
+    private:
+
+        static constexpr std::size_t writerIndex = 0u;
+
+        struct Connection
+        {
+            std::shared_ptr<Database> db;
+
+            bool busy = false;
+        };
+
+        ConnectionLease acquire(std::size_t first, std::size_t last);
+
+        // Returns last if all the connections in the range are busy, should be called under the lock.
+        std::size_t findFree(std::size_t first, std::size_t last) const;
+
+        void release(std::size_t index);
+
+        std::vector<Connection> m_connections;
+
+        std::mutex m_mutex;
+
+        std::condition_variable m_released;
+
+        friend ConnectionLease;
+    };
+}
@@ -3,10 +3,61 @@
 #include "SQLiteWrapper/Get.h"
 #include "SQLiteWrapper/Scalar.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cctype>
 #include <sstream>
 
 using namespace sqlite;
 
+namespace
+{
+    int traceCallback(unsigned int type, void* context, void* p, void* x)
+    {
+        const TraceCallback& callback = *static_cast<const TraceCallback*>(context);
+
+        TraceEvent event{};
+
+        switch (type)
+        {
+            case SQLITE_TRACE_STMT:
+                event.kind = TraceKind::Statement;
+                event.stmt = static_cast<sqlite3_stmt*>(p);
+                event.sql = static_cast<const char*>(x);
+                break;
+
+            case SQLITE_TRACE_PROFILE:
+                event.kind = TraceKind::Profile;
+                event.stmt = static_cast<sqlite3_stmt*>(p);
+                event.time = std::chrono::nanoseconds(*static_cast<const sqlite3_int64*>(x));
+                break;
+
+            case SQLITE_TRACE_ROW:
+                event.kind = TraceKind::Row;
+                event.stmt = static_cast<sqlite3_stmt*>(p);
+                break;
+
+            case SQLITE_TRACE_CLOSE:
+                event.kind = TraceKind::Close;
+                break;
+
+            default:
+                return 0;
+        }
+
+        // An exception can't pass through SQLite.
+        try
+        {
+            callback(event);
+        }
+        catch (...)
+        {
+        }
+
+        return 0;
+    }
+}
+
 void Database::open(const char* fileName)
 {
     const int rc = sqlite3_open(fileName, &m_db);
@@ -19,6 +70,60 @@ void Database::open(const char* fileName)
     notify(&Element::create, std::ref(*this));
 }
 
+void Database::open(const char* fileName, int flags)
+{
+    DatabaseOptions options;
+
+    options.flags = flags;
+
+    open(fileName, options);
+}
+
+void Database::open(const char* fileName, const DatabaseOptions& options)
+{
+    const int rc = sqlite3_open_v2(fileName, &m_db, options.flags, nullptr);
+
+    // SQLite allocates the handle even if it fails to open the database.
+    auto guard = awl::make_scope_guard([this]()
+    {
+        sqlite3_close_v2(m_db);
+
+        m_db = nullptr;
+    });
+
+    if (rc != SQLITE_OK)
+    {
+        raiseError(m_db, rc, awl::aformat() << "Can't open database '" << fileName << "'");
+    }
+
+    const std::string pragmas = options.pragmas();
+
+    if (!pragmas.empty())
+    {
+        exec(pragmas);
+    }
+
+    // SQLite does not fail if it can't switch the journal mode, for example, an in-memory database can't use WAL.
+    if (!options.journalMode.empty())
+    {
+        Statement stmt(*this, "PRAGMA journal_mode;");
+
+        std::string journal_mode;
+
+        selectScalar(stmt, journal_mode);
+
+        if (!std::ranges::equal(journal_mode, options.journalMode, [](unsigned char a, unsigned char b) { return std::tolower(a) == std::tolower(b); }))
+        {
+            throw SQLiteException(0, awl::aformat() << "Can't switch database '" << fileName << "' to journal mode " << options.journalMode <<
+                ", the current journal mode is " << journal_mode << ".");
+        }
+    }
+
+    guard.release();
+
+    notify(&Element::create, std::ref(*this));
+}
+
 void Database::close()
 {
     if (m_db != nullptr)
@@ -26,7 +131,15 @@ void Database::close()
         // Close the statements.
         invalidateScheme();
 
-        sqlite3_close(m_db);
+        // If a Set, an iterator or a lease still has a statement, the connection is closed when the statement is finalized.
+        const int rc = sqlite3_close_v2(m_db);
+
+        if (rc != SQLITE_OK)
+        {
+            m_logger.get().error(awl::format() << _T("Can't close the database, error code: ") << rc << _T("."));
+        }
+
+        m_db = nullptr;
     }
 }
 
@@ -119,3 +232,51 @@ void Database::raiseError(sqlite3* db, int code, std::string message)
 
     throw SQLiteException(code, user_message);
 }
+
+std::size_t Database::setTrace(TraceMask mask, TraceCallback callback)
+{
+    // The identifiers are unique across the connections, because a connection can be moved.
+    static std::atomic<std::size_t> last_trace_id{ 0u };
+
+    unsigned int sqlite_mask = 0u;
+
+    for (const TraceKind kind : { TraceKind::Statement, TraceKind::Profile, TraceKind::Row, TraceKind::Close })
+    {
+        if (mask[kind])
+        {
+            sqlite_mask |= 1u << static_cast<unsigned int>(kind);
+        }
+    }
+
+    auto p_callback = std::make_unique<TraceCallback>(std::move(callback));
+
+    const int rc = sqlite3_trace_v2(m_db, sqlite_mask, traceCallback, p_callback.get());
+
+    if (rc != SQLITE_OK)
+    {
+        raiseError(m_db, rc, "Can't set trace callback");
+    }
+
+    m_traceCallback = std::move(p_callback);
+
+    m_traceId = ++last_trace_id;
+
+    return m_traceId;
+}
+
+void Database::clearTrace()
+{
+    sqlite3_trace_v2(m_db, 0, nullptr, nullptr);
+
+    m_traceCallback.reset();
+
+    m_traceId = 0u;
+}
+
+void Database::clearTrace(std::size_t trace_id)
+{
+    if (trace_id != 0u && trace_id == m_traceId)
+    {
+        clearTrace();
+    }
+}
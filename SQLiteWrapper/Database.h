@@ -6,14 +6,33 @@
 #include "SQLiteWrapper/Exception.h"
 #include "SQLiteWrapper/Element.h"
 #include "SQLiteWrapper/Statement.h"
+#include "SQLiteWrapper/StatementCache.h"
+#include "SQLiteWrapper/StatementMetrics.h"
+#include "SQLiteWrapper/SlowQueryLog.h"
+#include "SQLiteWrapper/Trace.h"
+#include "SQLiteWrapper/DatabaseOptions.h"
 
 #include "Awl/LegacyFormat.h"
 #include "Awl/Observable.h"
 #include "Awl/ScopeGuard.h"
 #include "Awl/Logger.h"
 
+#include <memory>
+
 namespace sqlite
 {
+#ifdef SQLITE_ENABLE_SNAPSHOT
+    struct SnapshotDeleter
+    {
+        void operator()(sqlite3_snapshot* p) const
+        {
+            sqlite3_snapshot_free(p);
+        }
+    };
+
+    using Snapshot = std::unique_ptr<sqlite3_snapshot, SnapshotDeleter>;
+#endif
+
     class Database : public awl::Observable<Element, Database>
     {
     public:
@@ -24,6 +43,18 @@ namespace sqlite
         {
             open(fileName);
         }
+
+        // The flags are passed to sqlite3_open_v2, for example SQLITE_OPEN_READONLY | SQLITE_OPEN_NOMUTEX.
+        Database(const char * fileName, int flags, awl::Logger& logger) : Database(logger)
+        {
+            open(fileName, flags);
+        }
+
+        // Applies the pragmas of the options before the observers create their tables.
+        Database(const char * fileName, const DatabaseOptions& options, awl::Logger& logger) : Database(logger)
+        {
+            open(fileName, options);
+        }
         
         ~Database()
         {
@@ -39,17 +70,42 @@ namespace sqlite
             m_db(std::move(other.m_db))
         {
             other.m_db = nullptr;
+
+            std::swap(m_statementCache, other.m_statementCache);
+            std::swap(m_metrics, other.m_metrics);
+            std::swap(m_metricsEnabled, other.m_metricsEnabled);
+            std::swap(m_traceCallback, other.m_traceCallback);
+            std::swap(m_traceId, other.m_traceId);
+
+            moveSlowQueryLog(other);
         }
 
         Database& operator = (Database && other)
         {
+            // The trace callback of the closed connection is released with it.
+            close();
+
             m_db = other.m_db;
             other.m_db = nullptr;
+
+            std::swap(m_statementCache, other.m_statementCache);
+            std::swap(m_metrics, other.m_metrics);
+            std::swap(m_metricsEnabled, other.m_metricsEnabled);
+            std::swap(m_traceCallback, other.m_traceCallback);
+            std::swap(m_traceId, other.m_traceId);
+
+            moveSlowQueryLog(other);
+
             return *this;
         }
 
         void open(const char* fileName);
 
+        void open(const char* fileName, int flags);
+
+        // The connection is closed if it can't be configured as requested.
+        void open(const char* fileName, const DatabaseOptions& options);
+
         void close();
 
         void clear()
@@ -193,6 +249,23 @@ namespace sqlite
             }
         }
 
+        // Makes the connection wait for a lock held by another connection instead of returning SQLITE_BUSY.
+        void setBusyTimeout(int milliseconds)
+        {
+            const int rc = sqlite3_busy_timeout(m_db, milliseconds);
+
+            if (rc != SQLITE_OK)
+            {
+                raiseError(m_db, rc, "Can't set busy timeout");
+            }
+        }
+
+        //Returns false if a transaction is active.
+        bool isAutocommit() const
+        {
+            return sqlite3_get_autocommit(m_db) != 0;
+        }
+
         //Returns the number of rows modified, inserted or deleted by the most recently completed INSERT, UPDATE or DELETE statement.
         int affectedCount() const
         {
@@ -209,25 +282,129 @@ namespace sqlite
             }
         }
 
+        // Returns the current value of a run-time limit like SQLITE_LIMIT_VARIABLE_NUMBER.
+        int getLimit(int id) const
+        {
+            return sqlite3_limit(m_db, id, -1);
+        }
+
         RowId lastRowId() const
         {
             return sqlite3_last_insert_rowid(m_db);
         }
 
+        void setLastRowId(RowId id)
+        {
+            sqlite3_set_last_insert_rowid(m_db, id);
+        }
+
+#ifdef SQLITE_ENABLE_SNAPSHOT
+        // Records the state of the database seen by the current read transaction in WAL mode.
+        Snapshot getSnapshot()
+        {
+            sqlite3_snapshot* p = nullptr;
+
+            const int rc = sqlite3_snapshot_get(m_db, "main", &p);
+
+            if (rc != SQLITE_OK)
+            {
+                raiseError(m_db, rc, "Can't get a snapshot");
+            }
+
+            return Snapshot(p);
+        }
+
+        // Should be called after BEGIN, but before the transaction reads anything.
+        void openSnapshot(const Snapshot& snapshot)
+        {
+            const int rc = sqlite3_snapshot_open(m_db, "main", snapshot.get());
+
+            if (rc != SQLITE_OK)
+            {
+                raiseError(m_db, rc, "Can't open a snapshot");
+            }
+        }
+#endif
+
+        // The statements prepared by Set while the metrics are enabled report to the registry.
+        void enableMetrics(bool enable = true)
+        {
+            m_metricsEnabled = enable;
+        }
+
+        bool metricsEnabled() const
+        {
+            return m_metricsEnabled;
+        }
+
+        MetricsRegistry& metrics()
+        {
+            return m_metrics;
+        }
+
+        // The statements prepared by Set after this call report the executions longer than the threshold to the log.
+        void enableSlowQueryLog(std::chrono::nanoseconds threshold, int64_t large_table_row_count = SlowQueryLog::defaultLargeTableRowCount)
+        {
+            m_slowQueryLog = std::make_shared<SlowQueryLog>(*this, threshold, large_table_row_count);
+        }
+
+        void disableSlowQueryLog()
+        {
+            m_slowQueryLog.reset();
+        }
+
+        const std::shared_ptr<SlowQueryLog>& slowQueryLog() const
+        {
+            return m_slowQueryLog;
+        }
+
+        // Calls the callback on the thread using the connection for the events in the mask (sqlite3_trace_v2),
+        // the callback replaces the previous one.
+        // Returns the identifier of the callback, it is never zero.
+        std::size_t setTrace(TraceMask mask, TraceCallback callback);
+
+        void clearTrace();
+
+        // Clears the trace only if the callback with the given identifier has not been replaced.
+        void clearTrace(std::size_t trace_id);
+
         awl::Logger& logger()
         {
             return m_logger;
         }
 
+        StatementCache& statementCache()
+        {
+            return *m_statementCache;
+        }
+
         // Should be called after CREATE TABLE.
         void invalidateScheme()
         {
             tableExistsStatement.close();
             indexExistsStatement.close();
+
+            // The cached statements were prepared with the old scheme.
+            m_statementCache->clear();
         }
 
     private:
 
+        void moveSlowQueryLog(Database& other)
+        {
+            std::swap(m_slowQueryLog, other.m_slowQueryLog);
+
+            if (m_slowQueryLog != nullptr)
+            {
+                m_slowQueryLog->setDatabase(*this);
+            }
+
+            if (other.m_slowQueryLog != nullptr)
+            {
+                other.m_slowQueryLog->setDatabase(other);
+            }
+        }
+
         [[noreturn]]
         static void raiseError(sqlite3* db, int code, std::string message);
 
@@ -243,6 +420,21 @@ namespace sqlite
 
         std::size_t m_transactionLevel = 0u;
 
+        std::shared_ptr<StatementCache> m_statementCache = std::make_shared<StatementCache>();
+
+        MetricsRegistry m_metrics;
+
+        bool m_metricsEnabled = false;
+
+        // It refers to the database, so it is rebound when the connection is moved.
+        std::shared_ptr<SlowQueryLog> m_slowQueryLog;
+
+        // SQLite refers to the heap object as the trace context, so it is moved with the connection.
+        std::unique_ptr<TraceCallback> m_traceCallback;
+
+        // The identifier of the current trace callback or zero.
+        std::size_t m_traceId = 0u;
+
         Statement tableExistsStatement;
         Statement indexExistsStatement;
 
@@ -0,0 +1,118 @@
+#include "SQLiteWrapper/DatabaseOptions.h"
+
+#include <sstream>
+#include <stdexcept>
+
+using namespace sqlite;
+
+std::string DatabaseOptions::pragmas() const
+{
+    std::ostringstream out;
+
+    auto write = [&out](const char* name, const auto& value)
+    {
+        out << "PRAGMA " << name << " = " << value << ";";
+    };
+
+    if (pageSize)
+    {
+        write("page_size", *pageSize);
+    }
+
+    if (cacheSize)
+    {
+        write("cache_size", *cacheSize);
+    }
+
+    if (mmapSize)
+    {
+        write("mmap_size", *mmapSize);
+    }
+
+    if (!tempStore.empty())
+    {
+        write("temp_store", tempStore);
+    }
+
+    if (!lockingMode.empty())
+    {
+        write("locking_mode", lockingMode);
+    }
+
+    if (!journalMode.empty())
+    {
+        write("journal_mode", journalMode);
+    }
+
+    if (!synchronous.empty())
+    {
+        write("synchronous", synchronous);
+    }
+
+    if (walAutocheckpoint)
+    {
+        write("wal_autocheckpoint", *walAutocheckpoint);
+    }
+
+    return out.str();
+}
+
+DatabaseOptions DatabaseOptions::bulkLoad()
+{
+    DatabaseOptions options;
+
+    options.cacheSize = -262144;
+    options.journalMode = "MEMORY";
+    options.synchronous = "OFF";
+    options.tempStore = "MEMORY";
+    options.lockingMode = "EXCLUSIVE";
+
+    return options;
+}
+
+DatabaseOptions DatabaseOptions::lowLatencyOltp()
+{
+    DatabaseOptions options;
+
+    options.flags |= SQLITE_OPEN_NOMUTEX;
+    options.cacheSize = -65536;
+    options.mmapSize = 268435456;
+    options.journalMode = "WAL";
+    options.synchronous = "NORMAL";
+    options.tempStore = "MEMORY";
+    options.walAutocheckpoint = 1000;
+
+    return options;
+}
+
+DatabaseOptions DatabaseOptions::readOnlyAnalytics()
+{
+    DatabaseOptions options;
+
+    options.flags = SQLITE_OPEN_READONLY | SQLITE_OPEN_NOMUTEX;
+    options.cacheSize = -262144;
+    options.mmapSize = 1073741824;
+    options.tempStore = "MEMORY";
+
+    return options;
+}
+
+DatabaseOptions DatabaseOptions::preset(std::string_view name)
+{
+    if (name == "bulk-load")
+    {
+        return bulkLoad();
+    }
+
+    if (name == "low-latency-oltp")
+    {
+        return lowLatencyOltp();
+    }
+
+    if (name == "read-only-analytics")
+    {
+        return readOnlyAnalytics();
+    }
+
+    throw std::invalid_argument("Unknown database options preset '" + std::string(name) + "'.");
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "sqlite3.h"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace sqlite
+{
+    // The flags passed to sqlite3_open_v2 and the pragmas applied to the connection before it is used.
+    // An empty or unset pragma keeps the SQLite default.
+    struct DatabaseOptions
+    {
+        static constexpr int defaultFlags = SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE;
+
+        // For example SQLITE_OPEN_NOMUTEX or SQLITE_OPEN_FULLMUTEX, SQLITE_OPEN_READONLY, SQLITE_OPEN_URI, SQLITE_OPEN_PRIVATECACHE.
+        int flags = defaultFlags;
+
+        // Takes effect only before the database is created or by VACUUM, and not in WAL mode.
+        std::optional<int> pageSize;
+
+        // A positive value is the number of the pages, a negative value is the size in KiB.
+        std::optional<int64_t> cacheSize;
+
+        std::optional<int64_t> mmapSize;
+
+        // DELETE, TRUNCATE, PERSIST, MEMORY, WAL or OFF.
+        std::string journalMode;
+
+        // OFF, NORMAL, FULL or EXTRA.
+        std::string synchronous;
+
+        // DEFAULT, FILE or MEMORY.
+        std::string tempStore;
+
+        // NORMAL or EXCLUSIVE.
+        std::string lockingMode;
+
+        // The number of the WAL pages that triggers a checkpoint, zero disables automatic checkpoints.
+        std::optional<int> walAutocheckpoint;
+
+        // The pragma statements in the order they should be executed, the page size goes first
+        // and the locking mode precedes the journal mode, so WAL can work without shared memory.
+        std::string pragmas() const;
+
+        // Loading a lot of data by a single connection: no journal file, no syncs and an exclusive lock,
+        // a crash during the load can corrupt the database.
+        static DatabaseOptions bulkLoad();
+
+        // Short transactions of a connection used by one thread at a time: WAL with NORMAL synchronous
+        // does not sync on every commit, but the committed transactions survive an application crash.
+        static DatabaseOptions lowLatencyOltp();
+
+        // Long read-only queries: a large cache, memory mapped I/O and temporary sort tables in memory.
+        static DatabaseOptions readOnlyAnalytics();
+
+        // "bulk-load", "low-latency-oltp" or "read-only-analytics".
+        static DatabaseOptions preset(std::string_view name);
+    };
+}
@@ -12,6 +12,10 @@
 #include <limits>
 #include <chrono>
 #include <optional>
+#include <string>
+#include <string_view>
+#include <span>
+#include <vector>
 
 namespace sqlite
 {
@@ -77,7 +81,14 @@ namespace sqlite
 
     inline void get(Statement & st, size_t col, std::string & val)
     {
-        val = st.textValue(col);
+        // Reuses the capacity of val.
+        val.assign(st.textView(col));
+    }
+
+    // The view is valid until the statement is stepped or reset.
+    inline void get(Statement & st, size_t col, std::string_view & val)
+    {
+        val = st.textView(col);
     }
 
     inline void get(Statement & st, size_t col, const char * & val)
@@ -119,7 +130,15 @@ namespace sqlite
 
     inline void get(Statement& st, size_t col, std::vector<uint8_t>& val)
     {
-        val = st.blobValue(col);
+        const std::span<const uint8_t> view = st.blobView(col);
+
+        val.assign(view.begin(), view.end());
+    }
+
+    // The view is valid until the statement is stepped or reset.
+    inline void get(Statement& st, size_t col, std::span<const uint8_t>& val)
+    {
+        val = st.blobView(col);
     }
 
     template <class T>
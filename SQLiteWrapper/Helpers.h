@@ -14,7 +14,12 @@
 #include <vector>
 #include <optional>
 #include <string>
+#include <string_view>
+#include <span>
+#include <tuple>
 #include <set>
+#include <cstddef>
+#include <memory>
 
 namespace sqlite
 {
@@ -123,6 +128,58 @@ namespace sqlite::helpers
         using Type = T;
     };
 
+    template <class T>
+    struct IsView : std::false_type {};
+
+    template <>
+    struct IsView<std::string_view> : std::true_type {};
+
+    template <class T, std::size_t extent>
+    struct IsView<std::span<T, extent>> : std::true_type {};
+
+    template <class T>
+    struct IsTuple : std::false_type {};
+
+    template <class... T>
+    struct IsTuple<std::tuple<T...>> : std::true_type {};
+
+    template <class T>
+    constexpr bool hasViews();
+
+    template <class Tuple>
+    constexpr bool tupleHasViews()
+    {
+        bool result = false;
+
+        forEachTF<Tuple>([&result](auto fieldIndex)
+        {
+            result = result || hasViews<std::remove_cvref_t<std::tuple_element_t<fieldIndex, Tuple>>>();
+        });
+
+        return result;
+    }
+
+    // True if a value of the type (a column, a tuple or a reflectable structure) refers to the column buffers
+    // with std::string_view or std::span, so it is invalidated when the statement is stepped or reset.
+    template <class T>
+    constexpr bool hasViews()
+    {
+        using Field = RemoveOptionalT<T>;
+
+        if constexpr (awl::is_reflectable_v<Field>)
+        {
+            return tupleHasViews<typename awl::tuplizable_traits<Field>::Tie>();
+        }
+        else if constexpr (IsTuple<Field>::value)
+        {
+            return tupleHasViews<Field>();
+        }
+        else
+        {
+            return IsView<Field>::value;
+        }
+    }
+
     template <class T, typename Func>
     size_t forEachFieldTypeImpl(std::vector<std::string_view>& prefixes, Func&& func, size_t startIndex)
     {
@@ -166,60 +223,47 @@ namespace sqlite::helpers
         return forEachFieldTypeImpl<T>(prefixes, func, 0);
     }
 
-    template <class Struct, class T>
-    size_t findFieldIndex(T Struct::* fieldPtr)
+    template <class T>
+    constexpr inline size_t fieldCount()
     {
-        Struct instance = {};
-
-        size_t foundIndex = std::numeric_limits<size_t>::max();
+        size_t count = 0;
+        
+        using Tie = typename awl::tuplizable_traits<T>::Tie;
 
-        awl::for_each_index(instance.as_tuple(), [fieldPtr, &instance, &foundIndex](auto& field, auto fieldIndex)
+        forEachTF<Tie>([&count](auto fieldIndex)
         {
-            using FieldType = std::remove_reference_t<decltype(field)>;
+            using FieldType = std::remove_reference_t<std::tuple_element_t<fieldIndex, Tie>>;
 
-            if constexpr (std::is_same_v<FieldType, T>)
+            if constexpr (awl::is_reflectable_v<FieldType>)
             {
-                if (&field == &(instance.*fieldPtr))
-                {
-                    foundIndex = fieldIndex;
-                }
+                count += fieldCount<FieldType>();
             }
             else
             {
-                static_cast<void>(fieldIndex);
+                ++count;
             }
         });
 
-        assert(foundIndex != std::numeric_limits<size_t>::max());
-
-        return foundIndex;
+        return count;
     }
 
-    template <class Struct, class T>
-    const std::string& findFieldName(T Struct::* field_ptr)
-    {
-        const std::size_t index = findFieldIndex(field_ptr);
-
-        return Struct::member_names()[index];
-    }
-        
-    template <class T>
-    constexpr inline size_t fieldCount()
+    template <class T, typename Func>
+    constexpr size_t forEachFieldValueImpl(T& val, Func&& func, size_t start_index)
     {
         size_t count = 0;
-        
-        using Tie = typename awl::tuplizable_traits<T>::Tie;
 
-        forEachTF<Tie>([&count](auto fieldIndex)
+        awl::for_each(val.as_tuple(), [start_index, &count, &func](auto& field)
         {
-            using FieldType = std::remove_reference_t<std::tuple_element_t<fieldIndex, Tie>>;
+            using FieldType = std::remove_reference_t<decltype(field)>;
 
             if constexpr (awl::is_reflectable_v<FieldType>)
             {
-                count += fieldCount<FieldType>();
+                count += forEachFieldValueImpl(field, func, start_index + count);
             }
             else
             {
+                func(field, start_index + count);
+
                 ++count;
             }
         });
@@ -227,42 +271,148 @@ namespace sqlite::helpers
         return count;
     }
 
-    //TO DO: Make it possible to find an index of the tuple of field pointers.
-    //Now it finds only a top-level index.
-    template <class Struct, class T>
-    size_t findTransparentFieldIndex(T Struct::* fieldPtr)
+    template <class T, typename Func>
+    constexpr void forEachFieldValue(T& val, Func&& func)
     {
-        Struct instance = {};
+        forEachFieldValueImpl(val, func, 0);
+    }
 
-        size_t foundIndex = std::numeric_limits<size_t>::max();
+    // The address identifies the type.
+    template <class T>
+    inline constexpr char typeTag = 0;
 
-        size_t count = 0;
+    // The byte offset of a field (possibly nested) and its type.
+    struct FieldLocation
+    {
+        std::size_t offset;
+        const void* tag;
+    };
 
-        awl::for_each(instance.as_tuple(), [fieldPtr, &instance, &foundIndex, &count](auto& field)
+    // The locations of the top level fields and of the columns of a structure.
+    // They are found once per type with a single default-constructed instance,
+    // so resolving a field pointer does not construct the structure and does not allocate.
+    template <class Struct>
+    class FieldTable
+    {
+    public:
+
+        static const FieldTable& instance()
         {
-            using FieldType = std::remove_reference_t<decltype(field)>;
+            static const FieldTable table;
 
-            if constexpr (awl::is_reflectable_v<FieldType>)
+            return table;
+        }
+
+        template <class T>
+        FieldLocation locate(T Struct::* field_ptr) const
+        {
+            return FieldLocation{ offsetOf(m_sample.*field_ptr), &typeTag<T> };
+        }
+
+        std::size_t findFieldIndex(const FieldLocation& location) const
+        {
+            return find(m_fields, location);
+        }
+
+        std::size_t findColumnIndex(const FieldLocation& location) const
+        {
+            return find(m_columns, location);
+        }
+
+    private:
+
+        FieldTable()
+        {
+            awl::for_each(m_sample.as_tuple(), [this](auto& field)
             {
-                count += fieldCount<FieldType>();
-            }
-            else
+                using FieldType = std::remove_reference_t<decltype(field)>;
+
+                m_fields.push_back(FieldLocation{ offsetOf(field), &typeTag<FieldType> });
+            });
+
+            forEachFieldValue(m_sample, [this](auto& field, size_t field_index)
+            {
+                using FieldType = std::remove_reference_t<decltype(field)>;
+
+                m_columns[field_index] = FieldLocation{ offsetOf(field), &typeTag<FieldType> };
+            });
+        }
+
+        template <class T>
+        std::size_t offsetOf(const T& field) const
+        {
+            return static_cast<std::size_t>(reinterpret_cast<const std::byte*>(std::addressof(field)) -
+                reinterpret_cast<const std::byte*>(std::addressof(m_sample)));
+        }
+
+        template <class Container>
+        static std::size_t find(const Container& locations, const FieldLocation& location)
+        {
+            for (std::size_t i = 0; i < locations.size(); ++i)
             {
-                if constexpr (std::is_same_v<FieldType, T>)
+                // A nested structure and its first field have the same offset, but different types.
+                if (locations[i].offset == location.offset && locations[i].tag == location.tag)
                 {
-                    if (&field == &(instance.*fieldPtr))
-                    {
-                        foundIndex = count;
-                    }
+                    return i;
                 }
-
-                ++count;
             }
-        });
 
-        assert(foundIndex != std::numeric_limits<size_t>::max());
+            return noIndex;
+        }
+
+        Struct m_sample = {};
+
+        std::vector<FieldLocation> m_fields;
+
+        std::array<FieldLocation, fieldCount<Struct>()> m_columns;
+    };
+
+    template <class Struct, class T>
+    FieldLocation locateField(T Struct::* field_ptr)
+    {
+        return FieldTable<Struct>::instance().locate(field_ptr);
+    }
+
+    // A field of a nested structure is specified with a chain of field pointers,
+    // for example, (&Market::precision, &Precision::price).
+    template <class Struct, class Nested, class... Path> requires awl::is_reflectable_v<Nested> && (sizeof...(Path) != 0)
+    FieldLocation locateField(Nested Struct::* nested_ptr, Path... path)
+    {
+        FieldLocation location = locateField(path...);
+
+        location.offset += locateField(nested_ptr).offset;
+
+        return location;
+    }
+
+    // Returns the index of a top level field.
+    template <class Struct, class T>
+    size_t findFieldIndex(T Struct::* field_ptr)
+    {
+        const size_t found_index = FieldTable<Struct>::instance().findFieldIndex(locateField(field_ptr));
+
+        assert(found_index != noIndex);
+
+        return found_index;
+    }
+
+    template <class Struct, class T>
+    const std::string& findFieldName(T Struct::* field_ptr)
+    {
+        const std::size_t index = findFieldIndex(field_ptr);
+
+        return Struct::member_names()[index];
+    }
+
+    // Returns the column index of a top level field or of a field of a nested structure.
+    template <class Struct, class T, class... Path>
+    size_t findTransparentFieldIndex(T Struct::* field_ptr, Path... path)
+    {
+        const size_t found_index = FieldTable<Struct>::instance().findColumnIndex(locateField(field_ptr, path...));
+
+        assert(found_index != noIndex);
 
-        return foundIndex;
+        return found_index;
     }
 
     template <class Value, class... Field>
@@ -280,62 +430,34 @@ namespace sqlite::helpers
         return indices;
     }
 
-    /*
-    template <class T, class Tuple, std::size_t level_index>
-    constexpr inline size_t findFieldIndexImpl(Tuple t)
+    // A field path is a field pointer or a tuple of field pointers to a field of a nested structure,
+    // for example, std::make_tuple(&Market::precision, &Precision::price).
+    template <class Value, class T>
+    size_t findPathIndex(T Value::* field_ptr)
     {
-        size_t count = 0;
-
-        using Tie = typename awl::tuplizable_traits<T>::Tie;
+        return findTransparentFieldIndex(field_ptr);
+    }
 
-        forEachTF<Tie>([&count](auto fieldIndex)
+    template <class Value, class T, class... Path>
+    size_t findPathIndex(const std::tuple<T Value::*, Path...>& path)
+    {
+        return std::apply([](auto... field_ptrs)
         {
-            using FieldType = std::remove_reference_t<std::tuple_element_t<fieldIndex, Tie>>;
-
-            if constexpr (awl::is_reflectable_v<FieldType>)
-            {
-                return findFieldIndex<FieldType, Tuple, level_index>(t);
-            }
-            else
-            {
-
-
-                ++count;
-            }
-        });
-
-        return count;
+            return findTransparentFieldIndex(field_ptrs...);
+        }, path);
     }
-    */
 
-    template <class T, typename Func>
-    constexpr size_t forEachFieldValueImpl(T& val, Func&& func, size_t start_index)
+    template <class Value, class... Path>
+    IndexFilter findPathIndices(const std::tuple<Path...>& paths)
     {
-        size_t count = 0;
+        IndexFilter indices;
 
-        awl::for_each(val.as_tuple(), [start_index, &count, &func](auto& field)
+        awl::for_each(paths, [&indices](auto& path)
         {
-            using FieldType = std::remove_reference_t<decltype(field)>;
-
-            if constexpr (awl::is_reflectable_v<FieldType>)
-            {
-                count += forEachFieldValueImpl(field, func, start_index + count);
-            }
-            else
-            {
-                func(field, start_index + count);
-
-                ++count;
-            }
+            indices.insert(findPathIndex<Value>(path));
         });
 
-        return count;
-    }
-
-    template <class T, typename Func>
-    constexpr void forEachFieldValue(T& val, Func&& func)
-    {
-        forEachFieldValueImpl(val, func, 0);
+        return indices;
     }
 
     inline std::string makeFullFieldName(std::vector<std::string_view>& prefixes, std::string_view name)
@@ -381,5 +503,38 @@ namespace sqlite::helpers
                 }
             });
     }
-}
 
+    class ColumnNameVisitor
+    {
+    public:
+
+        bool containsColumn(size_t) const
+        {
+            return true;
+        }
+
+        template <class FieldType>
+        void addColumn(const std::string& full_name, size_t)
+        {
+            names.push_back(full_name);
+        }
+
+        std::vector<std::string> names;
+    };
+
+    // The full names of the columns indexed by the column, they are built once per type.
+    template <class Struct>
+    const std::vector<std::string>& columnNames()
+    {
+        static const std::vector<std::string> names = []()
+        {
+            ColumnNameVisitor visitor;
+
+            forEachColumn<Struct>(visitor);
+
+            return std::move(visitor.names);
+        }();
+
+        return names;
+    }
+}
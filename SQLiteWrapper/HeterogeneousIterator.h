@@ -44,6 +44,11 @@ namespace sqlite
             return m_s->Next();
         }
 
+        std::size_t stepCount() const
+        {
+            return m_s->stepCount();
+        }
+
         template <class T>
         void get(size_t col, T& val)
         {
@@ -1,6 +1,9 @@
 #pragma once
 
 #include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include <initializer_list>
 
 namespace sqlite
 {
@@ -13,7 +16,13 @@ namespace sqlite
 
         IndexFilter() = default;
 
-        IndexFilter(std::initializer_list<size_t> init) : m_v(init) {}
+        IndexFilter(std::initializer_list<size_t> init)
+        {
+            for (size_t val : init)
+            {
+                insert(val);
+            }
+        }
 
         iterator begin() const { return m_v.begin(); }
 
@@ -21,31 +30,51 @@ namespace sqlite
 
         bool contains(size_t val) const
         {
-            return std::find(m_v.begin(), m_v.end(), val) != m_v.end();
+            return val < m_positions.size() && m_positions[val] != noPosition;
         }
 
         void insert(size_t val)
         {
+            // It also rejects noIndex returned for a field that was not found.
+            if (val > maxIndex)
+            {
+                throw std::out_of_range("Index is out of range.");
+            }
+
             if (contains(val))
             {
                 throw std::runtime_error("Duplicated index.");
             }
 
+            if (val >= m_positions.size())
+            {
+                m_positions.resize(val + 1, noPosition);
+            }
+
+            m_positions[val] = m_v.size();
+
             m_v.push_back(val);
         }
 
         bool erase(size_t val)
         {
-            auto i = std::find(m_v.begin(), m_v.end(), val);
-
-            if (i != m_v.end())
+            if (!contains(val))
             {
-                m_v.erase(i);
+                return false;
+            }
+
+            const size_t pos = m_positions[val];
+
+            m_v.erase(m_v.begin() + pos);
+
+            m_positions[val] = noPosition;
 
-                return true;
+            for (size_t i = pos; i < m_v.size(); ++i)
+            {
+                m_positions[m_v[i]] = i;
             }
 
-            return false;
+            return true;
         }
 
         size_t size() const { return m_v.size(); }
@@ -57,20 +86,27 @@ namespace sqlite
 
         size_t index_of(size_t val) const
         {
-            auto i = std::find(m_v.begin(), m_v.end(), val);
-
-            if (i == m_v.end())
+            if (!contains(val))
             {
                 throw std::runtime_error("Element not found.");
             }
 
-            return i - m_v.begin();
+            return m_positions[val];
         }
 
     private:
 
+        static constexpr size_t noPosition = static_cast<size_t>(-1);
+
+        // SQLite does not allow more than 32767 columns, so the positions are never resized beyond that.
+        static constexpr size_t maxIndex = 32766;
+
         // The vector should not be sorted.
         // The elements should stay in the order we added them in, see Set::bindKey.
         std::vector<size_t> m_v;
+
+        // The positions of the elements in m_v indexed by the element, it is sized by the greatest element,
+        // that is at most the field count, so contains() and index_of() do not search.
+        std::vector<size_t> m_positions;
     };
 }
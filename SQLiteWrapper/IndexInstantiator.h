@@ -106,7 +106,11 @@ namespace sqlite
 
             db.logger().debug(awl::format() << "'" << indexName << "' IndexInstantiator select query: " << query);
 
-            return Statement(db, query);
+            Statement stmt;
+
+            stmt.openCached(db, query);
+
+            return stmt;
         }
 
     private:
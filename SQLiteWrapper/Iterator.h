@@ -1,9 +1,11 @@
 #pragma once
 
 #include "HeterogeneousIterator.h"
+#include "SQLiteWrapper/Bind.h"
 
 #include <optional>
 #include <ranges>
+#include <utility>
 
 namespace sqlite
 {
@@ -72,6 +74,8 @@ namespace sqlite
 
                 m_v = std::move(val);
 
+                m_stepCount = m_i.stepCount();
+
                 return true;
             }
 
@@ -82,19 +86,112 @@ namespace sqlite
 
         T* cur() const
         {
-            T& val = *m_v;
+            T& val = cur_ref();
 
             return &val;
         }
 
         T& cur_ref() const
         {
+            // The record can contain std::string_view or std::span members pointing to the column buffers
+            // that are invalidated when the statement is stepped or reset.
+            if constexpr (helpers::hasViews<T>())
+            {
+                assert(m_stepCount == m_i.stepCount());
+            }
+
             return *m_v;
         }
 
         HeterogeneousIterator m_i;
 
         mutable std::optional<T> m_v;
+
+        std::size_t m_stepCount = 0u;
+    };
+
+    // Decodes every row into the same value, so the strings and the vectors of the value
+    // reuse their capacity and there is no per row construction and move.
+    // The value is overwritten when the iterator is incremented.
+    template <class T>
+    class ReusingIterator
+    {
+    public:
+
+        using iterator_category = std::input_iterator_tag;
+
+        using value_type = T;
+
+        using difference_type = std::ptrdiff_t;
+
+        using pointer = value_type*;
+
+        using reference = value_type&;
+
+        ReusingIterator() = default;
+
+        ReusingIterator(Statement& s) : m_i(s)
+        {
+            try_next();
+        }
+
+        ReusingIterator(const ReusingIterator&) = delete;
+
+        ReusingIterator& operator = (const ReusingIterator&) = delete;
+
+        ReusingIterator(ReusingIterator&& other) = default;
+
+        ReusingIterator& operator = (ReusingIterator&& other) = default;
+
+        T* operator-> () { return &cur_ref(); }
+
+        T& operator* () const { return cur_ref(); }
+
+        bool operator== (const IteratorSentinel<T>&) const noexcept
+        {
+            return m_end;
+        }
+
+        ReusingIterator& operator++ ()
+        {
+            try_next();
+
+            return *this;
+        }
+
+        void operator++ (int)
+        {
+            ++(*this);
+        }
+
+    private:
+
+        void try_next()
+        {
+            m_end = !m_i.Next();
+
+            if (!m_end)
+            {
+                m_i.get(m_v);
+
+                m_stepCount = m_i.stepCount();
+            }
+        }
+
+        T& cur_ref() const
+        {
+            assert(!m_end && m_stepCount == m_i.stepCount());
+
+            return m_v;
+        }
+
+        HeterogeneousIterator m_i;
+
+        mutable T m_v{};
+
+        std::size_t m_stepCount = 0u;
+
+        bool m_end = true;
     };
 
     template <class T>
@@ -102,4 +199,38 @@ namespace sqlite
     {
         return std::ranges::subrange(Iterator<T>(s), IteratorSentinel<T>{});
     }
+
+    template <class T>
+    auto make_reusing_range(Statement& s)
+    {
+        return std::ranges::subrange(ReusingIterator<T>(s), IteratorSentinel<T>{});
+    }
+
+    // Binds the parameters when the iteration begins and keeps them alive until the range is destroyed,
+    // because SQLite reads the parameters bound with SQLITE_STATIC again on each step.
+    template <class T, class Params>
+    class BoundRange
+    {
+    public:
+
+        BoundRange(Statement& s, Params params) : m_s(&s), m_params(std::move(params)) {}
+
+        Iterator<T> begin()
+        {
+            sqlite::bind(*m_s, 0, m_params);
+
+            return Iterator<T>(*m_s);
+        }
+
+        IteratorSentinel<T> end() const
+        {
+            return IteratorSentinel<T>{};
+        }
+
+    private:
+
+        Statement* m_s;
+
+        Params m_params;
+    };
 }
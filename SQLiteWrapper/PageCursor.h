@@ -0,0 +1,210 @@
+#pragma once
+
+#include "SQLiteWrapper/Set.h"
+#include "SQLiteWrapper/RowCodec.h"
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+#include <stdexcept>
+
+namespace sqlite
+{
+    // Reads a table page by page in the key order. A page starts after the last key of the previous page:
+    // SELECT ... WHERE (k1,k2)>(?1,?2) ORDER BY k1,k2 LIMIT ?3;
+    // so reading a page takes the same time regardless of its number, unlike LIMIT with OFFSET.
+    template <class Value, class... Keys>
+    class PageCursor
+    {
+    public:
+
+        using SetType = Set<Value, Keys...>;
+
+        using KeyTuple = std::tuple<Keys...>;
+
+        // The last key of the previous page, it is empty before the first page.
+        // It consists of the standard types, so it can be saved and passed to a cursor created later.
+        using State = std::optional<KeyTuple>;
+
+        static constexpr size_t defaultPageSize = 1000;
+
+        PageCursor(SetType& set, size_t page_size = defaultPageSize, State state = {}) :
+            m_set(set),
+            m_state(std::move(state))
+        {
+            setPageSize(page_size);
+        }
+
+        // Replaces the contents of the vector with the next page, returns false if there are no more rows.
+        bool next(std::vector<Value>& page)
+        {
+            page.clear();
+
+            Statement& stmt = m_state ? nextStatement() : firstStatement();
+
+            size_t col = 0;
+
+            if (m_state)
+            {
+                sqlite::bind(stmt, col, *m_state);
+
+                col += sizeof...(Keys);
+            }
+
+            sqlite::bind(stmt, col, static_cast<int64_t>(m_pageSize));
+
+            try
+            {
+                while (stmt.Next())
+                {
+                    Value val;
+
+                    sqlite::get(stmt, 0, val);
+
+                    page.push_back(std::move(val));
+                }
+            }
+            catch (const std::exception&)
+            {
+                // Reset returns the error of the failed step again.
+                try
+                {
+                    stmt.reset();
+                }
+                catch (const SQLiteException&)
+                {
+                }
+
+                stmt.clearBindings();
+
+                throw;
+            }
+
+            stmt.reset();
+            stmt.clearBindings();
+
+            if (page.empty())
+            {
+                return false;
+            }
+
+            m_state = makeKey(page.back());
+
+            return true;
+        }
+
+        const State& state() const
+        {
+            return m_state;
+        }
+
+        // Starts over or continues from a saved state.
+        void setState(State state)
+        {
+            m_state = std::move(state);
+        }
+
+        // The state as a text that can be persisted between requests, it is empty before the first page.
+        std::string saveState() const
+        {
+            if (!m_state)
+            {
+                return {};
+            }
+
+            Statement stmt(*m_set.m_db, buildParameterRowQuery(sizeof...(Keys)));
+
+            sqlite::bind(stmt, 0, *m_state);
+
+            if (!stmt.Next())
+            {
+                throw std::logic_error("A parameter row query has returned no rows.");
+            }
+
+            return encodeRow(stmt, sizeof...(Keys));
+        }
+
+        // Continues from the state returned by saveState, an empty text starts over.
+        void restoreState(std::string_view encoded)
+        {
+            if (encoded.empty())
+            {
+                m_state.reset();
+
+                return;
+            }
+
+            Statement stmt(*m_set.m_db, buildParameterRowQuery(sizeof...(Keys)));
+
+            std::vector<std::vector<uint8_t>> buffers;
+
+            if (bindEncodedRow(stmt, encoded, buffers) != sizeof...(Keys) || !stmt.Next())
+            {
+                throw std::invalid_argument("The encoded state does not match the key.");
+            }
+
+            KeyTuple key;
+
+            sqlite::get(stmt, 0, key);
+
+            m_state = std::move(key);
+        }
+
+        size_t pageSize() const
+        {
+            return m_pageSize;
+        }
+
+        void setPageSize(size_t page_size)
+        {
+            if (page_size == 0)
+            {
+                throw std::invalid_argument("Page size should not be zero.");
+            }
+
+            m_pageSize = page_size;
+        }
+
+    private:
+
+        KeyTuple makeKey(const Value& val) const
+        {
+            return std::apply([&val](auto... id_ptrs)
+            {
+                return KeyTuple(val.*id_ptrs...);
+            }, m_set.idPtrs);
+        }
+
+        Statement& firstStatement()
+        {
+            return openStatement(m_firstStatement, 0);
+        }
+
+        Statement& nextStatement()
+        {
+            return openStatement(m_nextStatement, sizeof...(Keys));
+        }
+
+        Statement& openStatement(Statement& stmt, size_t prefix_length)
+        {
+            if (!stmt.Isopen())
+            {
+                stmt = m_set.makeStatement("page", buildParameterizedRangeQuery<Value>(m_set.tableName, m_set.idIndices, prefix_length, ">", true));
+            }
+
+            return stmt;
+        }
+
+        SetType& m_set;
+
+        State m_state;
+
+        size_t m_pageSize;
+
+        Statement m_firstStatement;
+
+        Statement m_nextStatement;
+    };
+}
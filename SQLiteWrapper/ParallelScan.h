@@ -0,0 +1,172 @@
+#pragma once
+
+#include "SQLiteWrapper/ConnectionPool.h"
+#include "SQLiteWrapper/QueryBuilder.h"
+#include "SQLiteWrapper/Statement.h"
+#include "SQLiteWrapper/Bind.h"
+#include "SQLiteWrapper/Get.h"
+#include "SQLiteWrapper/Iterator.h"
+
+#include "Awl/ScopeGuard.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <exception>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef SQLITE_ENABLE_SNAPSHOT
+    #error Parallel scan requires SQLite compiled with SQLITE_ENABLE_SNAPSHOT.
+#endif
+
+namespace sqlite
+{
+    // Splits the rowid range of a table between min(rowid) and max(rowid) into thread_count equal ranges
+    // and reads each range in its own thread on its own reader of the pool. func(shard_index, value) is called
+    // on the thread of the shard with shard_index < thread_count, so the shards can aggregate without locking.
+    // The first shard is read on the calling thread and all the shards read the snapshot of the first shard.
+    // The number of the shards is limited by the number of the free readers, so a reader leased by the caller
+    // is not waited for, but the caller should leave at least one reader free.
+    template <class Value, class Func>
+    void parallelScan(ConnectionPool& pool, const std::string& table_name, size_t thread_count, Func&& func)
+    {
+        if (thread_count == 0 || pool.readerCount() == 0)
+        {
+            throw std::invalid_argument("Parallel scan requires at least one thread and one reader.");
+        }
+
+        std::vector<ConnectionLease> leases;
+
+        leases.push_back(pool.acquireReader());
+
+        while (leases.size() < thread_count)
+        {
+            ConnectionLease lease = pool.tryAcquireReader();
+
+            if (!lease.acquired())
+            {
+                break;
+            }
+
+            leases.push_back(std::move(lease));
+        }
+
+        const size_t shard_count = leases.size();
+
+        const std::string query = buildParameterizedRowIdRangeQuery<Value>(table_name);
+
+        auto scan_shard = [&query, &func](Database& db, size_t shard_index, RowId first_id, RowId last_id)
+        {
+            Statement stmt(db, query);
+
+            sqlite::bind(stmt, 0, first_id);
+            sqlite::bind(stmt, 1, last_id);
+
+            for (Value& val : make_reusing_range<Value>(stmt))
+            {
+                func(shard_index, val);
+            }
+        };
+
+        Database& db = *leases[0];
+
+        db.tryOutermost([&]()
+        {
+            RowId min_id = 0;
+            RowId max_id = 0;
+
+            {
+                Statement stmt(db, awl::aformat() << "SELECT (SELECT min(" << rowIdFieldName << ") FROM " << table_name <<
+                    "), (SELECT max(" << rowIdFieldName << ") FROM " << table_name << ");");
+
+                if (!stmt.Next() || stmt.isNull(0))
+                {
+                    // The table is empty.
+                    return;
+                }
+
+                sqlite::get(stmt, 0, min_id);
+                sqlite::get(stmt, 1, max_id);
+            }
+
+            const Snapshot snapshot = db.getSnapshot();
+
+            // The rowids can be negative and the range can be wider than the maximum of int64_t.
+            const uint64_t span = static_cast<uint64_t>(max_id) - static_cast<uint64_t>(min_id);
+
+            const uint64_t step = span / shard_count + 1;
+
+            auto first_of = [min_id, step](size_t shard_index)
+            {
+                return static_cast<RowId>(static_cast<uint64_t>(min_id) + shard_index * step);
+            };
+
+            auto last_of = [min_id, step, span](size_t shard_index)
+            {
+                return static_cast<RowId>(static_cast<uint64_t>(min_id) + std::min((shard_index + 1) * step - 1, span));
+            };
+
+            std::vector<std::exception_ptr> errors(shard_count);
+
+            std::vector<std::thread> threads;
+            threads.reserve(shard_count - 1);
+
+            // The started threads refer to the locals, so they are joined even if starting the next one throws.
+            auto join_guard = awl::make_scope_guard([&threads]()
+            {
+                for (std::thread& thread : threads)
+                {
+                    thread.join();
+                }
+            });
+
+            for (size_t shard_index = 1; shard_index < shard_count && shard_index * step <= span; ++shard_index)
+            {
+                threads.emplace_back([&, shard_index]()
+                {
+                    try
+                    {
+                        Database& shard_db = *leases[shard_index];
+
+                        shard_db.tryOutermost([&]()
+                        {
+                            shard_db.openSnapshot(snapshot);
+
+                            scan_shard(shard_db, shard_index, first_of(shard_index), last_of(shard_index));
+                        });
+                    }
+                    catch (...)
+                    {
+                        errors[shard_index] = std::current_exception();
+                    }
+                });
+            }
+
+            try
+            {
+                scan_shard(db, 0, first_of(0), last_of(0));
+            }
+            catch (...)
+            {
+                errors[0] = std::current_exception();
+            }
+
+            join_guard.release();
+
+            for (std::thread& thread : threads)
+            {
+                thread.join();
+            }
+
+            for (const std::exception_ptr& error : errors)
+            {
+                if (error)
+                {
+                    std::rethrow_exception(error);
+                }
+            }
+        });
+    }
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "SQLiteWrapper/Statement.h"
+#include "SQLiteWrapper/Bind.h"
+#include "SQLiteWrapper/Get.h"
+#include "SQLiteWrapper/Iterator.h"
+
+#include <tuple>
+
+namespace sqlite
+{
+    // Reads some columns of a set into a projection, that is a structure or a tuple with the fields
+    // of the same types in the same order. The other columns are not decoded and if the selected columns
+    // and the key are in an index SQLite reads only the index.
+    template <class Projection, class... Keys>
+    class Projector
+    {
+    public:
+
+        using KeyTuple = std::tuple<Keys...>;
+
+        Projector(Statement find_statement, Statement iterate_statement) :
+            m_findStatement(std::move(find_statement)),
+            m_iterateStatement(std::move(iterate_statement))
+        {
+        }
+
+        Projector(const Projector&) = delete;
+
+        Projector& operator = (const Projector&) = delete;
+
+        Projector(Projector&& other) = default;
+
+        Projector& operator = (Projector&& other) = default;
+
+        bool find(const KeyTuple& ids, Projection& val)
+        {
+            sqlite::bind(m_findStatement, 0, ids);
+
+            const bool exists = m_findStatement.Next();
+
+            if (exists)
+            {
+                sqlite::get(m_findStatement, 0, val);
+            }
+
+            m_findStatement.reset();
+
+            return exists;
+        }
+
+        Iterator<Projection> begin()
+        {
+            return m_iterateStatement;
+        }
+
+        IteratorSentinel<Projection> end()
+        {
+            return IteratorSentinel<Projection>{};
+        }
+
+    private:
+
+        Statement m_findStatement;
+
+        Statement m_iterateStatement;
+    };
+}
@@ -33,9 +33,17 @@ namespace sqlite
             m_out << " FROM " << table_name;
         }
 
-        void Startinsert(const std::string& table_name, const OptionalIndexFilter& filter = {})
+        // The conflict resolution is IGNORE, REPLACE, etc.
+        void Startinsert(const std::string& table_name, const OptionalIndexFilter& filter = {}, std::string_view conflict_resolution = {})
         {
-            m_out << "INSERT INTO " << table_name << " (";
+            m_out << "INSERT ";
+
+            if (!conflict_resolution.empty())
+            {
+                m_out << "OR " << conflict_resolution << " ";
+            }
+
+            m_out << "INTO " << table_name << " (";
 
             addFieldNames(filter);
 
@@ -87,15 +95,16 @@ namespace sqlite
             m_out << text;
         }
 
-        void addParameters(const OptionalIndexFilter& filter = {})
+        // The offset is added to the parameter indices of a row in a multi-row insert.
+        void addParameters(const OptionalIndexFilter& filter = {}, size_t offset = 0)
         {
             m_out << " (";
 
             auto sep = makeCommaSeparator();
 
-            auto add = [this, &sep](size_t i)
+            auto add = [this, &sep, offset](size_t i)
             {
-                m_out << sep << "?" << (i + 1);
+                m_out << sep << "?" << (offset + i + 1);
             };
 
             if (filter)
@@ -272,14 +281,145 @@ namespace sqlite
             helpers::findTransparentFieldIndices(std::make_tuple(where_id_ptr)), true);
     }
         
+    // Builds INSERT ... VALUES (?1,?2),(?3,?4),... with row_count rows,
+    // the parameters of row i start at i * helpers::fieldCount<Struct>().
     template <class Struct>
-    std::string buildParameterizedInsertQuery(const std::string& table_name, const OptionalIndexFilter& filter = {})
+    std::string buildParameterizedInsertQuery(const std::string& table_name, const OptionalIndexFilter& filter = {}, size_t row_count = 1)
     {
         QueryBuilder<Struct> builder;
 
         builder.Startinsert(table_name, filter);
-        
-        builder.addParameters(filter);
+
+        for (size_t row_index = 0; row_index < row_count; ++row_index)
+        {
+            if (row_index != 0)
+            {
+                builder.addText(",");
+            }
+
+            builder.addParameters(filter, row_index * helpers::fieldCount<Struct>());
+        }
+
+        builder.addTerminator();
+
+        return builder.str();
+    }
+
+    // INSERT OR IGNORE or INSERT OR REPLACE with a single row.
+    template <class Struct>
+    std::string buildParameterizedInsertOrQuery(const std::string& table_name, std::string_view conflict_resolution)
+    {
+        QueryBuilder<Struct> builder;
+
+        builder.Startinsert(table_name, {}, conflict_resolution);
+
+        builder.addParameters();
+
+        builder.addTerminator();
+
+        return builder.str();
+    }
+
+    // Inserts a row or updates the row with the same key:
+    // INSERT INTO t (k1,c2,c3) VALUES (?1,?2,?3) ON CONFLICT(k1) DO UPDATE SET c2=excluded.c2,c3=excluded.c3;
+    // A table containing only key columns has nothing to update, so it is DO NOTHING.
+    template <class Struct>
+    std::string buildParameterizedUpsertQuery(const std::string& table_name, const IndexFilter& key_fields, const IndexFilter& set_fields)
+    {
+        const std::vector<std::string>& names = helpers::columnNames<Struct>();
+
+        QueryBuilder<Struct> builder;
+
+        builder.Startinsert(table_name);
+
+        builder.addParameters();
+
+        builder << " ON CONFLICT(";
+
+        for (size_t column_index : key_fields)
+        {
+            if (column_index != *key_fields.begin())
+            {
+                builder << ",";
+            }
+
+            builder << names[column_index];
+        }
+
+        builder << ")";
+
+        if (set_fields.empty())
+        {
+            builder << " DO NOTHING";
+        }
+        else
+        {
+            builder << " DO UPDATE SET ";
+
+            for (size_t column_index : set_fields)
+            {
+                if (column_index != *set_fields.begin())
+                {
+                    builder << ",";
+                }
+
+                builder << names[column_index] << "=excluded." << names[column_index];
+            }
+        }
+
+        builder.addTerminator();
+
+        return builder.str();
+    }
+
+    // Selects the columns in the order of the filter, not in the order of the structure,
+    // so they can be read into a projection with the fields in the same order:
+    // SELECT c7,c5 FROM t WHERE k1=?1 AND k2=?2;
+    template <class Struct>
+    std::string buildParameterizedProjectionQuery(const std::string& table_name, const IndexFilter& select_fields,
+        const OptionalIndexFilter& where_fields = {})
+    {
+        const std::vector<std::string>& names = helpers::columnNames<Struct>();
+
+        QueryBuilder<Struct> builder;
+
+        builder << "SELECT ";
+
+        for (size_t column_index : select_fields)
+        {
+            if (column_index != *select_fields.begin())
+            {
+                builder << ",";
+            }
+
+            builder << names[column_index];
+        }
+
+        builder << " FROM " << table_name;
+
+        if (where_fields)
+        {
+            builder.addWhere();
+
+            builder.addFieldNames(where_fields, { FieldOption::Parametized, FieldOption::SequentialBindingIndices }, makeAndSeparator());
+        }
+
+        builder.addTerminator();
+
+        return builder.str();
+    }
+
+    // SELECT ... FROM t WHERE rowId BETWEEN ?1 AND ?2;
+    template <class Struct>
+    std::string buildParameterizedRowIdRangeQuery(const std::string& table_name)
+    {
+        QueryBuilder<Struct> builder;
+
+        builder.Startselect(table_name);
+
+        builder.addWhere();
+
+        builder << rowIdFieldName << " BETWEEN ?1 AND ?2";
 
         builder.addTerminator();
 
@@ -320,5 +460,137 @@ namespace sqlite
 
         return builder.str();
     }
-}
 
+    // Selects the rows with the first prefix_length key columns compared with the parameters as a row value
+    // and orders them by the key, for example:
+    // SELECT ... FROM t WHERE (k1,k2)>=(?1,?2) ORDER BY k1,k2,k3;
+    // so SQLite iterates over the primary key index.
+    // With limit_parameter the query ends with LIMIT ?(prefix_length + 1).
+    template <class Struct>
+    std::string buildParameterizedRangeQuery(const std::string& table_name, const IndexFilter& key_fields, size_t prefix_length, std::string_view op,
+        bool limit_parameter = false)
+    {
+        const std::vector<std::string>& names = helpers::columnNames<Struct>();
+
+        auto make_list = [&key_fields, &names](size_t count)
+        {
+            std::string list;
+
+            size_t i = 0;
+
+            for (auto key_i = key_fields.begin(); i < count; ++key_i, ++i)
+            {
+                if (i != 0)
+                {
+                    list += ",";
+                }
+
+                list += names[*key_i];
+            }
+
+            return list;
+        };
+
+        QueryBuilder<Struct> builder;
+
+        builder.Startselect(table_name);
+
+        if (prefix_length != 0)
+        {
+            builder.addWhere();
+
+            builder << "(" << make_list(prefix_length) << ")" << op;
+
+            IndexFilter parameters;
+
+            for (size_t i = 0; i < prefix_length; ++i)
+            {
+                parameters.insert(i);
+            }
+
+            builder.addParameters(parameters);
+        }
+
+        builder << " ORDER BY " << make_list(key_fields.size());
+
+        if (limit_parameter)
+        {
+            builder << " LIMIT ?" << prefix_length + 1;
+        }
+
+        builder.addTerminator();
+
+        return builder.str();
+    }
+
+    // Looks up row_count keys with one statement, the first column is the position of the key in the list:
+    // WITH find_keys(i,k1,k2) AS (VALUES (0,?1,?2),(1,?3,?4)) SELECT find_keys.i,t.c1,t.c2,... FROM find_keys JOIN t ON t.k1=find_keys.k1 AND t.k2=find_keys.k2;
+    // The parameters of the key i start at i * key_fields.size().
+    template <class Struct>
+    std::string buildParameterizedFindManyQuery(const std::string& table_name, const IndexFilter& key_fields, size_t row_count)
+    {
+        static constexpr char keysName[] = "find_keys";
+
+        const std::vector<std::string>& names = helpers::columnNames<Struct>();
+
+        QueryBuilder<Struct> builder;
+
+        builder << "WITH " << keysName << "(i";
+
+        for (size_t column_index : key_fields)
+        {
+            builder << "," << names[column_index];
+        }
+
+        builder << ") AS (VALUES ";
+
+        size_t parameter_index = 0;
+
+        for (size_t row_index = 0; row_index < row_count; ++row_index)
+        {
+            if (row_index != 0)
+            {
+                builder << ",";
+            }
+
+            builder << "(" << row_index;
+
+            for (size_t i = 0; i < key_fields.size(); ++i)
+            {
+                builder << ",?" << ++parameter_index;
+            }
+
+            builder << ")";
+        }
+
+        builder << ") SELECT " << keysName << ".i,";
+
+        {
+            FieldListBuilder<Struct> field_builder = builder.makeFieldBuilder();
+
+            field_builder.table_name = table_name;
+
+            builder.addFieldNames(field_builder);
+        }
+
+        builder << " FROM " << keysName << " JOIN " << table_name << " ON ";
+
+        {
+            size_t i = 0;
+
+            for (size_t column_index : key_fields)
+            {
+                if (i++ != 0)
+                {
+                    builder << " AND ";
+                }
+
+                builder << table_name << "." << names[column_index] << "=" << keysName << "." << names[column_index];
+            }
+        }
+
+        builder.addTerminator();
+
+        return builder.str();
+    }
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <atomic>
+#include <vector>
+#include <bit>
+#include <algorithm>
+#include <cstddef>
+
+namespace sqlite
+{
+    // A fixed-size lock-free queue with a single producer and a single consumer.
+    // The producer and the consumer can change threads if they are synchronized by other means,
+    // for example, a connection is passed to another thread with a mutex.
+    template <class T>
+    class SpscRingBuffer
+    {
+    public:
+
+        // The capacity is rounded up to a power of two.
+        explicit SpscRingBuffer(std::size_t capacity) :
+            m_slots(std::bit_ceil(std::max(capacity, std::size_t(2)))),
+            m_mask(m_slots.size() - 1)
+        {
+        }
+
+        SpscRingBuffer(const SpscRingBuffer&) = delete;
+
+        SpscRingBuffer& operator = (const SpscRingBuffer&) = delete;
+
+        // Returns false if the buffer is full.
+        bool tryPush(const T& val)
+        {
+            const std::size_t tail = m_tail.load(std::memory_order_relaxed);
+
+            if (tail - m_head.load(std::memory_order_acquire) == m_slots.size())
+            {
+                return false;
+            }
+
+            m_slots[tail & m_mask] = val;
+
+            m_tail.store(tail + 1, std::memory_order_release);
+
+            return true;
+        }
+
+        // Returns false if the buffer is empty.
+        bool tryPop(T& val)
+        {
+            const std::size_t head = m_head.load(std::memory_order_relaxed);
+
+            if (head == m_tail.load(std::memory_order_acquire))
+            {
+                return false;
+            }
+
+            val = m_slots[head & m_mask];
+
+            m_head.store(head + 1, std::memory_order_release);
+
+            return true;
+        }
+
+        std::size_t capacity() const
+        {
+            return m_slots.size();
+        }
+
+    private:
+
+        std::vector<T> m_slots;
+
+        const std::size_t m_mask;
+
+        // The consumer and the producer indices are on different cache lines.
+        alignas(64) std::atomic<std::size_t> m_head{ 0u };
+
+        alignas(64) std::atomic<std::size_t> m_tail{ 0u };
+    };
+}
@@ -0,0 +1,224 @@
+#include "SQLiteWrapper/RowCodec.h"
+
+#include "Awl/LegacyFormat.h"
+
+#include <bit>
+#include <span>
+#include <stdexcept>
+
+using namespace sqlite;
+
+namespace
+{
+    // A value is a type letter followed by its data in hex:
+    // 'n' - null, 'i' - 16 digits of int64, 'f' - 16 digits of the bits of double,
+    // 't' and 'b' - 8 digits of the size and two digits per byte of a text or a blob.
+    constexpr char hexDigits[] = "0123456789abcdef";
+
+    void writeHex(std::string& out, uint64_t val, size_t digit_count)
+    {
+        for (size_t i = digit_count; i != 0; --i)
+        {
+            out.push_back(hexDigits[(val >> ((i - 1) * 4)) & 0xF]);
+        }
+    }
+
+    void writeBytes(std::string& out, std::span<const uint8_t> bytes)
+    {
+        writeHex(out, bytes.size(), 8);
+
+        for (const uint8_t b : bytes)
+        {
+            writeHex(out, b, 2);
+        }
+    }
+
+    class Reader
+    {
+    public:
+
+        explicit Reader(std::string_view encoded) : m_encoded(encoded) {}
+
+        bool empty() const
+        {
+            return m_pos == m_encoded.size();
+        }
+
+        char readType()
+        {
+            ensure(1);
+
+            return m_encoded[m_pos++];
+        }
+
+        uint64_t readHex(size_t digit_count)
+        {
+            ensure(digit_count);
+
+            uint64_t val = 0;
+
+            for (size_t i = 0; i < digit_count; ++i)
+            {
+                const char c = m_encoded[m_pos++];
+
+                uint64_t digit;
+
+                if (c >= '0' && c <= '9')
+                {
+                    digit = static_cast<uint64_t>(c - '0');
+                }
+                else if (c >= 'a' && c <= 'f')
+                {
+                    digit = static_cast<uint64_t>(c - 'a' + 10);
+                }
+                else
+                {
+                    throw std::invalid_argument("Wrong encoded row.");
+                }
+
+                val = (val << 4) | digit;
+            }
+
+            return val;
+        }
+
+        std::vector<uint8_t> readBytes()
+        {
+            const size_t size = static_cast<size_t>(readHex(8));
+
+            ensure(size * 2);
+
+            std::vector<uint8_t> bytes(size);
+
+            for (uint8_t& b : bytes)
+            {
+                b = static_cast<uint8_t>(readHex(2));
+            }
+
+            return bytes;
+        }
+
+    private:
+
+        void ensure(size_t count) const
+        {
+            if (m_encoded.size() - m_pos < count)
+            {
+                throw std::invalid_argument("Wrong encoded row.");
+            }
+        }
+
+        std::string_view m_encoded;
+
+        size_t m_pos = 0;
+    };
+}
+
+std::string sqlite::buildParameterRowQuery(size_t count)
+{
+    awl::aformat out;
+
+    out << "SELECT ";
+
+    for (size_t i = 1; i <= count; ++i)
+    {
+        if (i != 1)
+        {
+            out << ",";
+        }
+
+        out << "?" << i;
+    }
+
+    out << ";";
+
+    return out;
+}
+
+std::string sqlite::encodeRow(const Statement& stmt, size_t column_count)
+{
+    std::string out;
+
+    for (size_t col = 0; col < column_count; ++col)
+    {
+        if (stmt.isNull(col))
+        {
+            out.push_back('n');
+        }
+        else if (stmt.isInt(col))
+        {
+            out.push_back('i');
+
+            writeHex(out, static_cast<uint64_t>(stmt.int64Value(col)), 16);
+        }
+        else if (stmt.isFloat(col))
+        {
+            out.push_back('f');
+
+            writeHex(out, std::bit_cast<uint64_t>(stmt.doubleValue(col)), 16);
+        }
+        else if (stmt.isText(col))
+        {
+            out.push_back('t');
+
+            const std::string_view text = stmt.textView(col);
+
+            writeBytes(out, std::span<const uint8_t>(reinterpret_cast<const uint8_t*>(text.data()), text.size()));
+        }
+        else
+        {
+            out.push_back('b');
+
+            writeBytes(out, stmt.blobView(col));
+        }
+    }
+
+    return out;
+}
+
+size_t sqlite::bindEncodedRow(Statement& stmt, std::string_view encoded, std::vector<std::vector<uint8_t>>& buffers)
+{
+    Reader reader(encoded);
+
+    size_t col = 0;
+
+    for (; !reader.empty(); ++col)
+    {
+        switch (reader.readType())
+        {
+            case 'n':
+                stmt.bindNull(col);
+                break;
+
+            case 'i':
+                stmt.bindInt64(col, static_cast<sqlite3_int64>(reader.readHex(16)));
+                break;
+
+            case 'f':
+                stmt.bindDouble(col, std::bit_cast<double>(reader.readHex(16)));
+                break;
+
+            case 't':
+            {
+                const std::vector<uint8_t> bytes = reader.readBytes();
+
+                // An empty text is not null.
+                const std::string text(bytes.begin(), bytes.end());
+
+                stmt.bindText(col, text, Lifetime::Transient);
+                break;
+            }
+
+            case 'b':
+                buffers.push_back(reader.readBytes());
+
+                stmt.bindBlob(col, buffers.back());
+                break;
+
+            default:
+                throw std::invalid_argument("Wrong encoded row.");
+        }
+    }
+
+    return col;
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "SQLiteWrapper/Statement.h"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace sqlite
+{
+    // "SELECT ?1,?2,...;" converts the bound values to a row with the SQLite storage types.
+    std::string buildParameterRowQuery(size_t count);
+
+    // Encodes the first column_count values of the current row as a text that can be stored in a file,
+    // a database or a URL. The integers, the reals, the texts and the blobs are restored exactly.
+    std::string encodeRow(const Statement& stmt, size_t column_count);
+
+    // Binds the values of an encoded row starting from the first parameter and returns their number.
+    // The blobs are kept in the buffers until the statement is executed.
+    size_t bindEncodedRow(Statement& stmt, std::string_view encoded, std::vector<std::vector<uint8_t>>& buffers);
+}
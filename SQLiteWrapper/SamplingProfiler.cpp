@@ -0,0 +1,130 @@
+#include "SQLiteWrapper/SamplingProfiler.h"
+
+#include "Awl/ScopeGuard.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+using namespace sqlite;
+
+SamplingProfiler::SamplingProfiler(Database& db, const std::string& file_name, std::size_t sample_interval,
+    std::size_t capacity, std::chrono::milliseconds flush_interval) :
+    m_db(db),
+    m_out(file_name, std::ios::binary | std::ios::trunc),
+    m_sampleInterval(sample_interval),
+    m_flushInterval(flush_interval),
+    m_buffer(capacity)
+{
+    if (sample_interval == 0)
+    {
+        throw std::invalid_argument("Sample interval should not be zero.");
+    }
+
+    if (!m_out)
+    {
+        throw SQLiteException(awl::aformat() << "Can't create trace file '" << file_name << "'.");
+    }
+
+    writeTraceHeader(m_out);
+
+    // The thread is started last, so a failed setTrace does not leave a joinable thread.
+    m_traceId = m_db.setTrace({ TraceKind::Profile }, [this](const TraceEvent& event) { onProfile(event); });
+
+    auto guard = awl::make_scope_guard([this]() { m_db.clearTrace(m_traceId); });
+
+    m_thread = std::thread([this]() { run(); });
+
+    guard.release();
+}
+
+void SamplingProfiler::stop()
+{
+    if (m_thread.joinable())
+    {
+        // A callback set after the profiler is not removed.
+        m_db.clearTrace(m_traceId);
+
+        {
+            std::lock_guard lock(m_mutex);
+
+            m_stopping = true;
+        }
+
+        m_stopped.notify_one();
+
+        m_thread.join();
+
+        flush();
+    }
+}
+
+void SamplingProfiler::onProfile(const TraceEvent& event)
+{
+    if (m_executionCount++ % m_sampleInterval != 0)
+    {
+        return;
+    }
+
+    const char* sql = sqlite3_sql(event.stmt);
+
+    const std::string_view query = sql != nullptr ? sql : "";
+
+    TraceSample sample;
+
+    sample.time = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    sample.duration = event.time.count();
+    sample.queryHash = hashQuery(query);
+    sample.textSize = 0;
+
+    const bool new_query = !m_writtenQueries.contains(sample.queryHash);
+
+    if (new_query)
+    {
+        const std::size_t size = std::min(query.size(), TraceSample::maxTextSize);
+
+        std::memcpy(sample.text.data(), query.data(), size);
+
+        sample.textSize = static_cast<uint32_t>(size);
+    }
+
+    if (m_buffer.tryPush(sample))
+    {
+        if (new_query)
+        {
+            m_writtenQueries.insert(sample.queryHash);
+        }
+
+        m_sampleCount.fetch_add(1, std::memory_order_relaxed);
+    }
+    else
+    {
+        m_droppedCount.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void SamplingProfiler::run()
+{
+    std::unique_lock lock(m_mutex);
+
+    while (!m_stopped.wait_for(lock, m_flushInterval, [this]() { return m_stopping; }))
+    {
+        lock.unlock();
+
+        flush();
+
+        lock.lock();
+    }
+}
+
+void SamplingProfiler::flush()
+{
+    TraceSample sample;
+
+    while (m_buffer.tryPop(sample))
+    {
+        writeTraceSample(m_out, sample);
+    }
+
+    m_out.flush();
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "SQLiteWrapper/Database.h"
+#include "SQLiteWrapper/RingBuffer.h"
+#include "SQLiteWrapper/TraceFile.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_set>
+
+namespace sqlite
+{
+    // Records every sample_interval-th execution profiled by SQLite on the connection into a lock-free ring buffer,
+    // a background thread writes the buffer to a trace file (see TraceFile.h).
+    // The samples are dropped when the buffer is full, so the connection never waits for the file.
+    class SamplingProfiler
+    {
+    public:
+
+        static constexpr std::size_t defaultCapacity = 4096;
+
+        static constexpr std::chrono::milliseconds defaultFlushInterval{ 100 };
+
+        SamplingProfiler(Database& db, const std::string& file_name, std::size_t sample_interval = 1,
+            std::size_t capacity = defaultCapacity, std::chrono::milliseconds flush_interval = defaultFlushInterval);
+
+        SamplingProfiler(const SamplingProfiler&) = delete;
+
+        SamplingProfiler& operator = (const SamplingProfiler&) = delete;
+
+        ~SamplingProfiler()
+        {
+            stop();
+        }
+
+        // Removes the trace callback and writes the remaining samples.
+        void stop();
+
+        uint64_t sampleCount() const
+        {
+            return m_sampleCount.load(std::memory_order_relaxed);
+        }
+
+        uint64_t droppedCount() const
+        {
+            return m_droppedCount.load(std::memory_order_relaxed);
+        }
+
+    private:
+
+        void onProfile(const TraceEvent& event);
+
+        void run();
+
+        void flush();
+
+        Database& m_db;
+
+        std::size_t m_traceId = 0u;
+
+        std::ofstream m_out;
+
+        const std::size_t m_sampleInterval;
+
+        const std::chrono::milliseconds m_flushInterval;
+
+        // Used by the connection thread only.
+        uint64_t m_executionCount = 0u;
+
+        std::unordered_set<uint64_t> m_writtenQueries;
+
+        SpscRingBuffer<TraceSample> m_buffer;
+
+        std::atomic<uint64_t> m_sampleCount{ 0u };
+
+        std::atomic<uint64_t> m_droppedCount{ 0u };
+
+        std::mutex m_mutex;
+
+        std::condition_variable m_stopped;
+
+        bool m_stopping = false;
+
+        std::thread m_thread;
+    };
+}
@@ -2,21 +2,33 @@
 
 #include "Awl/LegacyFormat.h"
 #include "Awl/Separator.h"
+#include "Awl/ScopeGuard.h"
 
 #include "SQLiteWrapper/Helpers.h"
 #include "SQLiteWrapper/TableBuilder.h"
 #include "SQLiteWrapper/QueryBuilder.h"
 #include "SQLiteWrapper/Statement.h"
 #include "SQLiteWrapper/Bind.h"
+#include "SQLiteWrapper/BindPlan.h"
 #include "SQLiteWrapper/Get.h"
 #include "SQLiteWrapper/Updater.h"
 #include "SQLiteWrapper/Iterator.h"
+#include "SQLiteWrapper/Projector.h"
+#include "SQLiteWrapper/ColumnBatchReader.h"
 
 #include <deque>
+#include <vector>
+#include <span>
+#include <bit>
+#include <iterator>
 #include <limits>
 #include <string>
 #include <iostream>
 #include <algorithm>
+#include <utility>
+#include <tuple>
+#include <unordered_map>
+#include <mutex>
 
 namespace sqlite
 {
@@ -31,27 +43,32 @@ namespace sqlite
 
     public:
 
+        // insertRange commits every defaultCommitCount rows by default.
+        static constexpr size_t defaultCommitCount = 10000;
+
         Set(const std::shared_ptr<Database>& db, std::string table_name, PtrTuple id_ptrs) :
             m_db(db),
             tableName(std::move(table_name)),
             idPtrs(std::move(id_ptrs)),
-            idIndices(findKeyIndices())
+            idIndices(findKeyIndices()),
+            keyBindPlan(idIndices),
+            m_queries(findQueries())
         {
-            insertStatement = makeStatement("insert",  buildParameterizedInsertQuery<Record>(tableName));
+            const Queries& queries = *m_queries;
 
-            IndexFilter value_filter = valueFilter();
+            insertStatement = makeStatement("insert", queries.insert);
 
             // A table containins only key columns can't be updated.
-            if (!value_filter.empty())
+            if (!queries.update.empty())
             {
-                updateStatement = makeStatement("update", buildParameterizedUpdateQuery<Record>(tableName, std::move(value_filter), idIndices));
+                updateStatement = makeStatement("update", queries.update);
 
-                selectStatement = makeStatement("select", buildParameterizedSelectQuery<Record>(tableName, {}, idIndices));
+                selectStatement = makeStatement("select", queries.select);
             }
 
-            deleteStatement = makeStatement("delete", buildParameterizedDeleteQuery<Record>(tableName, idIndices));
+            deleteStatement = makeStatement("delete", queries.deleteElement);
 
-            iterateStatement = makeStatement("iterate", buildTrivialSelectQuery<Value>(tableName));
+            iterateStatement = makeStatement("iterate", queries.iterate);
         }
 
         Set(const Set&) = delete;
@@ -67,6 +84,24 @@ namespace sqlite
             selectStatement.close();
             deleteStatement.close();
             iterateStatement.close();
+            upsertStatement.close();
+            insertOrIgnoreStatement.close();
+            insertOrReplaceStatement.close();
+
+            for (Statement& stmt : bulkInsertStatements)
+            {
+                stmt.close();
+            }
+
+            for (Statement& stmt : rangeStatements)
+            {
+                stmt.close();
+            }
+
+            for (Statement& stmt : findManyStatements)
+            {
+                stmt.close();
+            }
         }
 
         Iterator<Value> begin()
@@ -79,6 +114,18 @@ namespace sqlite
             return IteratorSentinel<Value>{};
         }
 
+        // Iterates over the set with a single value reused for all the rows, see ReusingIterator.
+        auto reusingRange()
+        {
+            return make_reusing_range<Value>(iterateStatement);
+        }
+
+        // Reads the set into a vector per column batch by batch.
+        ColumnBatchReader<Value> readColumns(size_t batch_size = ColumnBatchReader<Value>::defaultBatchSize)
+        {
+            return ColumnBatchReader<Value>(iterateStatement, batch_size);
+        }
+
         void insert(const Value& val)
         {
             bindInsertFields(insertStatement, val);
@@ -93,6 +140,121 @@ namespace sqlite
             return insertStatement.tryexec();
         }
 
+        // Inserts the value or updates the row with the same key with a single step.
+        // Returns true if the row has been inserted and false if it has been updated.
+        // The inserted row is detected by the last insert rowid, so the table should have a rowid
+        // (the tables created by TableBuilder have it).
+        bool upsert(const Value& val)
+        {
+            Statement& stmt = prepare(upsertStatement, "upsert", &Queries::upsert);
+
+            bindInsertFields(stmt, val);
+
+            // A table containing only key columns is not updated on conflict.
+            if (valueCount() == 0)
+            {
+                stmt.exec();
+
+                return m_db->affectedCount() != 0;
+            }
+
+            const RowId last_row_id = m_db->lastRowId();
+
+            // DO UPDATE does not change the last insert rowid.
+            m_db->setLastRowId(upsertRowIdMark);
+
+            try
+            {
+                stmt.exec();
+            }
+            catch (...)
+            {
+                m_db->setLastRowId(last_row_id);
+
+                throw;
+            }
+
+            const bool inserted = m_db->lastRowId() != upsertRowIdMark;
+
+            if (!inserted)
+            {
+                m_db->setLastRowId(last_row_id);
+            }
+
+            return inserted;
+        }
+
+        // Returns false if the row has not been inserted because of a conflict with an existing row,
+        // unlike tryinsert it does not fail the step and it does not hide the errors other than the conflicts.
+        bool insertOrIgnore(const Value& val)
+        {
+            Statement& stmt = prepare(insertOrIgnoreStatement, "insert or ignore", &Queries::insertOrIgnore);
+
+            bindInsertFields(stmt, val);
+
+            stmt.exec();
+
+            return m_db->affectedCount() != 0;
+        }
+
+        // Deletes the rows conflicting with the value by the key or by any other unique constraint and inserts the value.
+        // SQLite does not count the deleted rows, so it is not known if a row has been replaced,
+        // use upsert to find it out.
+        void insertOrReplace(const Value& val)
+        {
+            Statement& stmt = prepare(insertOrReplaceStatement, "insert or replace", &Queries::insertOrReplace);
+
+            bindInsertFields(stmt, val);
+
+            stmt.exec();
+        }
+
+        // Inserts the values with multi-row INSERT statements and commits every commit_count rows.
+        // Inside of an outer transaction the rows are committed with the outer transaction.
+        // The values are bound without copying, so the iterators should refer to existing objects.
+        template <std::forward_iterator I, std::sentinel_for<I> S>
+            requires std::is_lvalue_reference_v<std::iter_reference_t<I>> && std::convertible_to<std::iter_reference_t<I>, const Value&>
+        void insertRange(I first, S last, size_t commit_count = defaultCommitCount)
+        {
+            if (commit_count == 0)
+            {
+                throw std::invalid_argument("Commit count should not be zero.");
+            }
+
+            const size_t max_rows = bulkInsertMaxRows();
+
+            while (first != last)
+            {
+                m_db->tryRun([this, &first, &last, commit_count, max_rows]()
+                {
+                    size_t row_count = 0;
+
+                    while (first != last && row_count < commit_count)
+                    {
+                        I chunk_first = first;
+
+                        const size_t chunk_limit = std::min(max_rows, commit_count - row_count);
+
+                        size_t chunk_size = 0;
+
+                        for (; first != last && chunk_size < chunk_limit; ++first)
+                        {
+                            ++chunk_size;
+                        }
+
+                        insertChunk(chunk_first, chunk_size);
+
+                        row_count += chunk_size;
+                    }
+                });
+            }
+        }
+
+        void insertBatch(std::span<const Value> values, size_t commit_count = defaultCommitCount)
+        {
+            insertRange(values.begin(), values.end(), commit_count);
+        }
+
         bool find(Value& val)
         {
             bindKeyFromValue(selectStatement, val);
@@ -107,6 +269,117 @@ namespace sqlite
             return selectValue(val);
         }
 
+        // The prefix contains the first keys, for example, (exchangeId, marketId) for the key (exchangeId, marketId, dt).
+        // The ranges are ordered by the key and use the primary key index.
+        // A range uses a statement of the set, so it should be destroyed before the next range
+        // of the same kind with the same prefix length is iterated over.
+
+        // The rows with the key prefix greater than or equal to the given one.
+        template <class... Prefix>
+        auto lowerBound(const std::tuple<Prefix...>& prefix)
+        {
+            return selectRange(RangeKind::LowerBound, prefix);
+        }
+
+        // The rows with the key prefix greater than the given one.
+        template <class... Prefix>
+        auto upperBound(const std::tuple<Prefix...>& prefix)
+        {
+            return selectRange(RangeKind::UpperBound, prefix);
+        }
+
+        // The rows with the key prefix equal to the given one.
+        template <class... Prefix>
+        auto equalRange(const std::tuple<Prefix...>& prefix)
+        {
+            return selectRange(RangeKind::EqualRange, prefix);
+        }
+
+        // Looks up the keys with a statement per chunk of up to the variable limit keys,
+        // the values and the found flags are in the order of the keys.
+        // Returns the number of the found keys.
+        size_t findMany(std::span<const KeyTuple> ids, std::vector<Value>& values, std::vector<bool>& found)
+        {
+            values.clear();
+            values.resize(ids.size());
+
+            found.assign(ids.size(), false);
+
+            const size_t max_rows = findManyMaxRows();
+
+            size_t found_count = 0;
+
+            size_t first_index = 0;
+
+            while (first_index != ids.size())
+            {
+                const size_t row_count = std::bit_floor(std::min(ids.size() - first_index, max_rows));
+
+                Statement& stmt = findManyStatement(row_count);
+
+                // The pooled statement is reused by the next call, so it is left reset if binding or stepping throws.
+                auto guard = awl::make_scope_guard([&stmt]()
+                {
+                    // Reset returns the error of the failed step again.
+                    try
+                    {
+                        stmt.reset();
+                    }
+                    catch (const SQLiteException&)
+                    {
+                    }
+
+                    stmt.clearBindings();
+                });
+
+                for (size_t row_index = 0; row_index < row_count; ++row_index)
+                {
+                    sqlite::bind(stmt, row_index * sizeof...(Keys), ids[first_index + row_index]);
+                }
+
+                while (stmt.Next())
+                {
+                    int64_t row_index;
+
+                    sqlite::get(stmt, 0, row_index);
+
+                    const size_t index = first_index + static_cast<size_t>(row_index);
+
+                    sqlite::get(stmt, 1, values[index]);
+
+                    if (!found[index])
+                    {
+                        found[index] = true;
+
+                        ++found_count;
+                    }
+                }
+
+                guard.release();
+
+                stmt.reset();
+
+                first_index += row_count;
+            }
+
+            return found_count;
+        }
+
+        // Selects only the given columns, for example:
+        // set.select<std::tuple<Decimal, OrderStatus>>(std::make_tuple(&Order::price, &Order::status));
+        // The fields of the projection are in the order of the pointers.
+        template <class Projection, class... Field>
+        Projector<Projection, Keys...> select(std::tuple<Field Value::*...> field_ptrs) const
+        {
+            static_assert(((!awl::is_reflectable_v<Field>) && ...), "A projection field should be a column, but not a structure.");
+
+            const IndexFilter select_filter = helpers::findTransparentFieldIndices(field_ptrs);
+
+            return Projector<Projection, Keys...>(
+                makeStatement("select projection", buildParameterizedProjectionQuery<Record>(tableName, select_filter, idIndices)),
+                makeStatement("iterate projection", buildParameterizedProjectionQuery<Record>(tableName, select_filter)));
+        }
+
         void update(const Value& val)
         {
             bind(updateStatement, 0, val);
@@ -116,10 +389,11 @@ namespace sqlite
             m_db->ensureAffected(1);
         }
 
+        // A field is a field pointer or a tuple of field pointers to a field of a nested structure.
         template <class... Field>
-        Updater<Record> createUpdater(std::tuple<Field Value::*...> field_ptrs) const
+        Updater<Record> createUpdater(std::tuple<Field...> field_paths) const
         {
-            IndexFilter value_filter = helpers::findTransparentFieldIndices(field_ptrs);
+            IndexFilter value_filter = helpers::findPathIndices<Value>(field_paths);
 
             Statement stmt = makeStatement("update", buildParameterizedUpdateQuery<Record>(tableName, value_filter, idIndices));
 
@@ -159,6 +433,152 @@ namespace sqlite
         template <class Value1, class Int> requires std::is_integral_v<Int>
         friend class AutoincrementSet;
 
+        template <class Value1, class... Keys1>
+        friend class PageCursor;
+
+        struct Queries
+        {
+            std::string insert;
+            std::string update;
+            std::string select;
+            std::string deleteElement;
+            std::string iterate;
+            std::string upsert;
+            std::string insertOrIgnore;
+            std::string insertOrReplace;
+        };
+
+        // The last insert rowid is set to this value before an upsert, a real row practically never has it.
+        static constexpr RowId upsertRowIdMark = std::numeric_limits<RowId>::min();
+
+        // The number of the table and key combinations whose queries are shared between the sets of the process.
+        static constexpr size_t maxSharedQueryCount = 256;
+
+        // The queries depend only on the table name and the key indices, so they are built once
+        // and the next sets of the same table only prepare the statements (or take them from the cache).
+        // The map is process-wide and does not refer to a database. It is cleared when it reaches maxSharedQueryCount,
+        // so many dynamic table names do not grow it without bound, and a set keeps its own queries.
+        std::shared_ptr<const Queries> findQueries() const
+        {
+            static std::mutex mutex;
+
+            static std::unordered_map<std::string, std::shared_ptr<const Queries>> map;
+
+            std::string key = tableName;
+
+            // A table name does not contain zeros.
+            key += '\0';
+
+            for (size_t i : idIndices)
+            {
+                key += ':';
+                key += std::to_string(i);
+            }
+
+            std::lock_guard lock(mutex);
+
+            if (auto i = map.find(key); i != map.end())
+            {
+                return i->second;
+            }
+
+            if (map.size() >= maxSharedQueryCount)
+            {
+                map.clear();
+            }
+
+            auto p_queries = std::make_shared<Queries>();
+
+            Queries& queries = *p_queries;
+
+            queries.insert = buildParameterizedInsertQuery<Record>(tableName);
+
+            IndexFilter value_filter = valueFilter();
+
+            queries.upsert = buildParameterizedUpsertQuery<Record>(tableName, idIndices, value_filter);
+
+            queries.insertOrIgnore = buildParameterizedInsertOrQuery<Record>(tableName, "IGNORE");
+
+            queries.insertOrReplace = buildParameterizedInsertOrQuery<Record>(tableName, "REPLACE");
+
+            if (!value_filter.empty())
+            {
+                queries.update = buildParameterizedUpdateQuery<Record>(tableName, std::move(value_filter), idIndices);
+
+                queries.select = buildParameterizedSelectQuery<Record>(tableName, {}, idIndices);
+            }
+
+            queries.deleteElement = buildParameterizedDeleteQuery<Record>(tableName, idIndices);
+
+            queries.iterate = buildTrivialSelectQuery<Value>(tableName);
+
+            map.emplace(std::move(key), p_queries);
+
+            return p_queries;
+        }
+
+        enum class RangeKind
+        {
+            LowerBound,
+            UpperBound,
+            EqualRange
+        };
+
+        static constexpr size_t rangeKindCount = 3;
+
+        template <size_t... index>
+        static auto keyPrefixType(std::index_sequence<index...>) -> std::tuple<std::tuple_element_t<index, KeyTuple>...>;
+
+        template <size_t length>
+        using KeyPrefix = decltype(keyPrefixType(std::make_index_sequence<length>()));
+
+        template <class... Prefix>
+        auto selectRange(RangeKind kind, const std::tuple<Prefix...>& prefix)
+        {
+            constexpr size_t prefix_length = sizeof...(Prefix);
+
+            static_assert(prefix_length != 0 && prefix_length <= sizeof...(Keys), "Wrong key prefix length.");
+
+            // Convert the prefix to the key types.
+            return BoundRange<Value, KeyPrefix<prefix_length>>(rangeStatement(kind, prefix_length), prefix);
+        }
+
+        Statement& rangeStatement(RangeKind kind, size_t prefix_length)
+        {
+            // The vector is never resized after that, because the ranges refer to its elements.
+            if (rangeStatements.empty())
+            {
+                rangeStatements.resize(rangeKindCount * (sizeof...(Keys) + 1));
+            }
+
+            Statement& stmt = rangeStatements[static_cast<size_t>(kind) * (sizeof...(Keys) + 1) + prefix_length];
+
+            if (!stmt.Isopen())
+            {
+                const char* op = kind == RangeKind::LowerBound ? ">=" : kind == RangeKind::UpperBound ? ">" : "=";
+
+                stmt = makeStatement("range", buildParameterizedRangeQuery<Record>(tableName, idIndices, prefix_length, op));
+            }
+
+            return stmt;
+        }
+
+        // The statements that are not used by all the sets are prepared on the first use.
+        Statement& prepare(Statement& stmt, const char* log_prefix, std::string Queries::* query_ptr)
+        {
+            if (!stmt.Isopen())
+            {
+                stmt = makeStatement(log_prefix, (*m_queries).*query_ptr);
+            }
+
+            return stmt;
+        }
+
+        size_t valueCount() const
+        {
+            return helpers::fieldCount<Record>() - idIndices.size();
+        }
+
         IndexFilter valueFilter() const
         {
             IndexFilter value_filter;
@@ -192,25 +612,101 @@ namespace sqlite
             });
         }
 
-        void bindValue(Statement& stmt, const Value& val, IndexFilter filter)
+        void bindKeyFromValue(Statement& stmt, const Value& val)
         {
-            helpers::forEachFieldValue(val, [this, &stmt, &filter](auto& field, auto field_index)
+            keyBindPlan.bind(stmt, val);
+        }
+
+        void bindInsertFields(Statement& stmt, const Value& val)
+        {
+            sqlite::bind(stmt, 0, val);
+        }
+
+        // The number of rows in the largest multi-row INSERT, it is a power of two.
+        size_t bulkInsertMaxRows() const
+        {
+            const size_t variable_limit = static_cast<size_t>(m_db->getLimit(SQLITE_LIMIT_VARIABLE_NUMBER));
+
+            return std::bit_floor(std::max(variable_limit / helpers::fieldCount<Record>(), size_t(1)));
+        }
+
+        // There is one statement per power of two, so a chunk of any size is inserted
+        // with at most log2(size) statements.
+        Statement& bulkInsertStatement(size_t row_count)
+        {
+            assert(std::has_single_bit(row_count));
+
+            if (row_count == 1)
             {
-                if (filter.contains(field_index))
-                {
-                    sqlite::bind(stmt, field_index, field);
-                }
-            });
+                return insertStatement;
+            }
+
+            const size_t index = static_cast<size_t>(std::countr_zero(row_count));
+
+            if (bulkInsertStatements.size() <= index)
+            {
+                bulkInsertStatements.resize(index + 1);
+            }
+
+            Statement& stmt = bulkInsertStatements[index];
+
+            if (!stmt.Isopen())
+            {
+                stmt = makeStatement("bulk insert", buildParameterizedInsertQuery<Record>(tableName, {}, row_count));
+            }
+
+            return stmt;
         }
 
-        void bindKeyFromValue(Statement& stmt, const Value& val)
+        // The number of keys in the largest findMany statement, it is a power of two.
+        size_t findManyMaxRows() const
         {
-            bindValue(stmt, val, idIndices);
+            const size_t variable_limit = static_cast<size_t>(m_db->getLimit(SQLITE_LIMIT_VARIABLE_NUMBER));
+
+            return std::bit_floor(std::max(variable_limit / sizeof...(Keys), size_t(1)));
         }
 
-        void bindInsertFields(Statement& stmt, const Value& val)
+        Statement& findManyStatement(size_t row_count)
         {
-            sqlite::bind(stmt, 0, val);
+            assert(std::has_single_bit(row_count));
+
+            const size_t index = static_cast<size_t>(std::countr_zero(row_count));
+
+            if (findManyStatements.size() <= index)
+            {
+                findManyStatements.resize(index + 1);
+            }
+
+            Statement& stmt = findManyStatements[index];
+
+            if (!stmt.Isopen())
+            {
+                stmt = makeStatement("find many", buildParameterizedFindManyQuery<Record>(tableName, idIndices, row_count));
+            }
+
+            return stmt;
+        }
+
+        template <class I>
+        void insertChunk(I first, size_t size)
+        {
+            while (size != 0)
+            {
+                const size_t row_count = std::bit_floor(size);
+
+                Statement& stmt = bulkInsertStatement(row_count);
+
+                for (size_t row_index = 0; row_index < row_count; ++row_index, ++first)
+                {
+                    const Value& val = *first;
+
+                    sqlite::bind(stmt, row_index * helpers::fieldCount<Record>(), val);
+                }
+
+                stmt.exec();
+
+                size -= row_count;
+            }
         }
 
         bool selectValue(Value& val)
@@ -231,7 +727,22 @@ namespace sqlite
         {
             m_db->logger().debug(awl::format() << "Set " << log_prefix << ": " << query);
 
-            return Statement(*m_db, query);
+            Statement stmt;
+
+            // Set statements are reused for the lifetime of the set.
+            stmt.openCached(*m_db, query, SQLITE_PREPARE_PERSISTENT);
+
+            if (m_db->metricsEnabled())
+            {
+                stmt.setMetrics(m_db->metrics().find(log_prefix, query));
+            }
+
+            if (m_db->slowQueryLog() != nullptr)
+            {
+                stmt.setSlowQueryLog(m_db->slowQueryLog());
+            }
+
+            return stmt;
         };
 
         std::shared_ptr<Database> m_db;
@@ -243,11 +754,28 @@ namespace sqlite
 
         const IndexFilter idIndices;
 
+        const BindPlan<Value> keyBindPlan;
+
+        // Shared with the other sets of the table, the statements that are prepared on the first use need them.
+        std::shared_ptr<const Queries> m_queries;
+
         Statement insertStatement;
         Statement updateStatement;
         Statement selectStatement;
         Statement deleteStatement;
         Statement iterateStatement;
+        Statement upsertStatement;
+        Statement insertOrIgnoreStatement;
+        Statement insertOrReplaceStatement;
+
+        // Multi-row INSERT statements indexed by log2 of the row count.
+        std::vector<Statement> bulkInsertStatements;
+
+        // Indexed by the range kind and the prefix length.
+        std::vector<Statement> rangeStatements;
+
+        // findMany statements indexed by log2 of the key count.
+        std::vector<Statement> findManyStatements;
     };
 }
 
@@ -0,0 +1,244 @@
+#include "SQLiteWrapper/SlowQueryLog.h"
+#include "SQLiteWrapper/Database.h"
+#include "SQLiteWrapper/Statement.h"
+#include "SQLiteWrapper/Bind.h"
+#include "SQLiteWrapper/Get.h"
+
+#include <algorithm>
+#include <cctype>
+#include <iomanip>
+#include <regex>
+#include <string_view>
+#include <unordered_map>
+
+using namespace sqlite;
+
+namespace
+{
+    // The name of the table in 'SCAN t', 'SCAN TABLE t' (before SQLite 3.36) or 'SCAN t USING COVERING INDEX i'.
+    std::string_view findScannedTable(std::string_view detail)
+    {
+        constexpr std::string_view scan = "SCAN ";
+        constexpr std::string_view table = "TABLE ";
+
+        if (!detail.starts_with(scan))
+        {
+            return {};
+        }
+
+        detail.remove_prefix(scan.size());
+
+        if (detail.starts_with(table))
+        {
+            detail.remove_prefix(table.size());
+        }
+
+        return detail.substr(0, detail.find(' '));
+    }
+
+    bool isKeyword(const std::string& word)
+    {
+        static const std::unordered_set<std::string> keywords =
+        {
+            "WHERE", "ON", "USING", "JOIN", "LEFT", "RIGHT", "FULL", "INNER", "OUTER", "CROSS", "NATURAL",
+            "GROUP", "ORDER", "HAVING", "WINDOW", "LIMIT", "UNION", "EXCEPT", "INTERSECT", "INDEXED", "NOT", "SET", "VALUES"
+        };
+
+        std::string upper = word;
+
+        std::ranges::transform(upper, upper.begin(), [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+
+        return keywords.contains(upper);
+    }
+
+    // EXPLAIN QUERY PLAN shows the alias of a table since SQLite 3.36, for example, 'SCAN o' for 'FROM orders o',
+    // so the aliases in 'FROM t a', 'JOIN t AS a' and 'FROM t1 a, t2 b' are mapped to the table names.
+    std::unordered_map<std::string, std::string> findAliases(const std::string& query)
+    {
+        static const std::regex alias_regex(R"re((?:\bFROM|\bJOIN|,)\s+"?(\w+)"?\s+(?:AS\s+)?"?(\w+)"?)re", std::regex::icase);
+
+        std::unordered_map<std::string, std::string> aliases;
+
+        for (auto i = std::sregex_iterator(query.begin(), query.end(), alias_regex); i != std::sregex_iterator(); ++i)
+        {
+            const std::string alias = (*i)[2].str();
+
+            if (!isKeyword(alias))
+            {
+                aliases.emplace(alias, (*i)[1].str());
+            }
+        }
+
+        return aliases;
+    }
+
+    // The names of the common table expressions in 'WITH c AS (' or 'c(x, y) AS ('.
+    std::unordered_set<std::string> findCommonTables(const std::string& query)
+    {
+        static const std::regex cte_regex(R"re(\b(\w+)\s*(?:\([^()]*\))?\s+AS\s+(?:NOT\s+)?(?:MATERIALIZED\s+)?\()re", std::regex::icase);
+
+        std::unordered_set<std::string> names;
+
+        for (auto i = std::sregex_iterator(query.begin(), query.end(), cte_regex); i != std::sregex_iterator(); ++i)
+        {
+            names.insert((*i)[1].str());
+        }
+
+        return names;
+    }
+}
+
+SlowQueryLog::SlowQueryLog(Database& db, std::chrono::nanoseconds threshold, int64_t large_table_row_count) :
+    m_db(&db),
+    m_threshold(threshold),
+    m_largeTableRowCount(large_table_row_count)
+{
+}
+
+void SlowQueryLog::report(const Statement& stmt, std::chrono::nanoseconds time)
+{
+    try
+    {
+        std::string query = stmt.query();
+
+        if (m_queries.contains(query))
+        {
+            return;
+        }
+
+        Entry entry{ query, stmt.expandedQuery(), time };
+
+        entry.plan = explain(query);
+
+        findLargeScans(query, entry);
+
+        write(entry);
+
+        m_queries.insert(std::move(query));
+
+        m_entries.push_back(std::move(entry));
+    }
+    catch (const std::exception& e)
+    {
+        m_db->logger().error(awl::format() << "Slow query log has failed: " << e.what());
+    }
+}
+
+std::vector<std::string> SlowQueryLog::explain(const std::string& query)
+{
+    std::vector<std::string> plan;
+
+    Statement stmt(*m_db, "EXPLAIN QUERY PLAN " + query);
+
+    while (stmt.Next())
+    {
+        std::string detail;
+
+        sqlite::get(stmt, 3, detail);
+
+        plan.push_back(std::move(detail));
+    }
+
+    stmt.reset();
+
+    return plan;
+}
+
+bool SlowQueryLog::isLargeTable(const std::string& table_name)
+{
+    // Counting is limited, so it does not scan a huge table.
+    Statement count(*m_db, awl::aformat() << "SELECT count(*) FROM (SELECT 1 FROM \"" << table_name << "\" LIMIT ?1);");
+
+    sqlite::bind(count, 0, m_largeTableRowCount);
+
+    int64_t row_count = 0;
+
+    if (count.Next())
+    {
+        sqlite::get(count, 0, row_count);
+    }
+
+    count.reset();
+
+    return row_count >= m_largeTableRowCount;
+}
+
+void SlowQueryLog::findLargeScans(const std::string& query, Entry& entry)
+{
+    const std::unordered_map<std::string, std::string> aliases = findAliases(query);
+
+    const std::unordered_set<std::string> common_tables = findCommonTables(query);
+
+    for (const std::string& detail : entry.plan)
+    {
+        const std::string name(findScannedTable(detail));
+
+        // A subquery is scanned as '(subquery-1)' and a CTE under its own name, but they are not tables.
+        if (name.empty() || name.starts_with("(") || common_tables.contains(name))
+        {
+            continue;
+        }
+
+        std::string table_name = name;
+
+        if (!m_db->tableExists(table_name))
+        {
+            auto i = aliases.find(name);
+
+            if (i != aliases.end() && common_tables.contains(i->second))
+            {
+                continue;
+            }
+
+            if (i != aliases.end() && m_db->tableExists(i->second))
+            {
+                table_name = i->second;
+            }
+            else
+            {
+                // The size is unknown, but a scan without an index is suspicious anyway, a virtual table has its own index.
+                if (detail.find(" USING ") == std::string::npos && detail.find(" VIRTUAL TABLE") == std::string::npos)
+                {
+                    entry.unresolvedScans.push_back(name);
+                }
+
+                continue;
+            }
+        }
+
+        if (isLargeTable(table_name))
+        {
+            entry.largeScans.push_back(table_name);
+        }
+    }
+}
+
+void SlowQueryLog::write(const Entry& entry)
+{
+    awl::aformat out;
+
+    out << "Slow query (" << std::fixed << std::setprecision(3) << std::chrono::duration<double, std::milli>(entry.time).count() << " ms): " <<
+        entry.expandedQuery;
+
+    if (!entry.plan.empty())
+    {
+        out << "\nQuery plan:";
+
+        for (const std::string& detail : entry.plan)
+        {
+            out << "\n    " << detail;
+        }
+    }
+
+    for (const std::string& table_name : entry.largeScans)
+    {
+        out << "\nFull scan of the large table '" << table_name << "', an index is probably missing.";
+    }
+
+    for (const std::string& name : entry.unresolvedScans)
+    {
+        out << "\nFull scan of '" << name << "' without an index, an index is probably missing.";
+    }
+
+    m_db->logger().warning(awl::format() << out.str());
+}
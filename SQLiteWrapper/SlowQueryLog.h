@@ -0,0 +1,93 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <unordered_set>
+
+namespace sqlite
+{
+    class Database;
+    class Statement;
+
+    // Logs the statements executed longer than the threshold once per SQL text
+    // with the bound parameters and EXPLAIN QUERY PLAN, the plans scanning large tables are flagged.
+    class SlowQueryLog
+    {
+    public:
+
+        static constexpr int64_t defaultLargeTableRowCount = 10000;
+
+        struct Entry
+        {
+            std::string query;
+
+            // The query with the parameters of the slow execution.
+            std::string expandedQuery;
+
+            std::chrono::nanoseconds time;
+
+            // The details of EXPLAIN QUERY PLAN rows.
+            std::vector<std::string> plan;
+
+            // The scanned tables with at least the large table row count rows, an alias is replaced with its table.
+            std::vector<std::string> largeScans;
+
+            // The names scanned without an index that are neither tables nor aliases of tables.
+            std::vector<std::string> unresolvedScans;
+        };
+
+        SlowQueryLog(Database& db, std::chrono::nanoseconds threshold, int64_t large_table_row_count = defaultLargeTableRowCount);
+
+        SlowQueryLog(const SlowQueryLog&) = delete;
+
+        SlowQueryLog& operator = (const SlowQueryLog&) = delete;
+
+        std::chrono::nanoseconds threshold() const
+        {
+            return m_threshold;
+        }
+
+        int64_t largeTableRowCount() const
+        {
+            return m_largeTableRowCount;
+        }
+
+        // Called by the statement when a slow execution is finished, it does not throw.
+        void report(const Statement& stmt, std::chrono::nanoseconds time);
+
+        const std::vector<Entry>& entries() const
+        {
+            return m_entries;
+        }
+
+    private:
+
+        std::vector<std::string> explain(const std::string& query);
+
+        bool isLargeTable(const std::string& table_name);
+
+        void findLargeScans(const std::string& query, Entry& entry);
+
+        void write(const Entry& entry);
+
+        // Called when the connection is moved to another Database.
+        void setDatabase(Database& db)
+        {
+            m_db = &db;
+        }
+
+        Database* m_db;
+
+        const std::chrono::nanoseconds m_threshold;
+
+        const int64_t m_largeTableRowCount;
+
+        std::unordered_set<std::string> m_queries;
+
+        std::vector<Entry> m_entries;
+
+        friend Database;
+    };
+}
@@ -1,6 +1,9 @@
 #include "SQLiteWrapper/Statement.h"
 #include "SQLiteWrapper/Database.h"
 
+#include <chrono>
+#include <algorithm>
+
 using namespace sqlite;
 
 [[noreturn]] void Statement::raiseError(int code, std::string message)
@@ -18,12 +21,143 @@ using namespace sqlite;
     throw SQLiteException(0, message);
 }
 
-void Statement::open(Database& db, const char* query)
+void Statement::open(Database& db, const char* query, unsigned int prepare_flags)
 {
-    const int rc = sqlite3_prepare(db.m_db, query, -1, &m_stmt, NULL);
+    const int rc = sqlite3_prepare_v3(db.m_db, query, -1, prepare_flags, &m_stmt, NULL);
 
     if (rc != SQLITE_OK)
     {
         Database::raiseError(db.m_db, rc, awl::aformat() << "Error while preparing SQL query: '" << query << "'.");
     }
 }
+
+void Statement::openCached(Database& db, const std::string& query, unsigned int prepare_flags)
+{
+    const std::shared_ptr<StatementCache>& cache = db.m_statementCache;
+
+    m_stmt = cache->checkout(query, prepare_flags);
+
+    if (m_stmt == nullptr)
+    {
+        open(db, query.c_str(), prepare_flags);
+    }
+
+    m_cache = cache;
+    m_query = query;
+    m_prepareFlags = prepare_flags;
+    m_cacheGeneration = cache->generation();
+}
+
+void Statement::setMetrics(std::shared_ptr<StatementMetrics> metrics)
+{
+    if (Isopen())
+    {
+        if (m_metrics != nullptr)
+        {
+            collectStatus();
+        }
+        else
+        {
+            // Discard the counters of the previous executions, a cached statement can have them.
+            for (const int op : { SQLITE_STMTSTATUS_FULLSCAN_STEP, SQLITE_STMTSTATUS_SORT, SQLITE_STMTSTATUS_AUTOINDEX,
+                SQLITE_STMTSTATUS_VM_STEP, SQLITE_STMTSTATUS_REPREPARE })
+            {
+                sqlite3_stmt_status(m_stmt, op, 1);
+            }
+        }
+    }
+
+    m_metrics = std::move(metrics);
+}
+
+int Statement::measuredStep()
+{
+    if (sqlite3_stmt_busy(m_stmt) == 0)
+    {
+        m_executionTime = {};
+
+        if (m_metrics != nullptr)
+        {
+            ++m_metrics->callCount;
+        }
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+
+    const int rc = sqlite3_step(m_stmt);
+
+    const std::chrono::nanoseconds elapsed = std::chrono::steady_clock::now() - start;
+
+    m_executionTime += elapsed;
+
+    if (m_metrics != nullptr)
+    {
+        StatementMetrics& metrics = *m_metrics;
+
+        ++metrics.stepCount;
+
+        metrics.totalStepTime += elapsed;
+
+        metrics.maxStepTime = std::max(metrics.maxStepTime, elapsed);
+
+        if (rc == SQLITE_ROW)
+        {
+            ++metrics.rowCount;
+        }
+    }
+
+    if (rc != SQLITE_ROW)
+    {
+        finishExecution();
+    }
+
+    return rc;
+}
+
+void Statement::finishExecution()
+{
+    if (m_metrics != nullptr)
+    {
+        collectStatus();
+    }
+
+    // The execution is reported once, because the time is zeroed.
+    if (m_slowQueryLog != nullptr && m_executionTime > m_slowQueryLog->threshold())
+    {
+        m_slowQueryLog->report(*this, m_executionTime);
+    }
+
+    m_executionTime = {};
+}
+
+std::string Statement::expandedQuery() const
+{
+    char* p = sqlite3_expanded_sql(m_stmt);
+
+    if (p == nullptr)
+    {
+        return query();
+    }
+
+    std::string text = p;
+
+    sqlite3_free(p);
+
+    return text;
+}
+
+void Statement::collectStatus()
+{
+    StatementMetrics& metrics = *m_metrics;
+
+    auto take = [this](int op)
+    {
+        return static_cast<uint64_t>(sqlite3_stmt_status(m_stmt, op, 1));
+    };
+
+    metrics.fullscanStepCount += take(SQLITE_STMTSTATUS_FULLSCAN_STEP);
+    metrics.sortCount += take(SQLITE_STMTSTATUS_SORT);
+    metrics.autoindexCount += take(SQLITE_STMTSTATUS_AUTOINDEX);
+    metrics.vmStepCount += take(SQLITE_STMTSTATUS_VM_STEP);
+    metrics.reprepareCount += take(SQLITE_STMTSTATUS_REPREPARE);
+}
@@ -3,21 +3,38 @@
 #include "sqlite3.h"
 
 #include "SQLiteWrapper/Exception.h"
+#include "SQLiteWrapper/StatementCache.h"
+#include "SQLiteWrapper/StatementMetrics.h"
+#include "SQLiteWrapper/SlowQueryLog.h"
+#include "SQLiteWrapper/BumpArena.h"
 
 #include "Awl/TupleHelpers.h"
-#include "Awl/QuickList.h"
 
 #include <stdint.h>
 #include <type_traits>
 #include <vector>
 #include <limits>
 #include <chrono>
-#include <any>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <span>
 
 namespace sqlite
 {
     class Database;
 
+    // Defines how long a bound text should be kept alive.
+    enum class Lifetime
+    {
+        // The caller keeps the text alive until the statement is executed.
+        Static,
+        // SQLite makes its own copy of the text.
+        Transient,
+        // The statement copies the text to its own buffer that is reused by the next bindings of the parameter.
+        Owned
+    };
+
     class Statement
     {
     public:
@@ -30,6 +47,14 @@ namespace sqlite
         }
 
         Statement(Database& db, const std::string& query) : Statement(db, query.c_str()) {}
+
+        // The flags are passed to sqlite3_prepare_v3, for example SQLITE_PREPARE_PERSISTENT or SQLITE_PREPARE_NO_VTAB.
+        Statement(Database& db, const char* query, unsigned int prepare_flags)
+        {
+            open(db, query, prepare_flags);
+        }
+
+        Statement(Database& db, const std::string& query, unsigned int prepare_flags) : Statement(db, query.c_str(), prepare_flags) {}
             
         Statement(const Statement&) = delete;
 
@@ -37,25 +62,42 @@ namespace sqlite
 
         Statement(Statement&& other) : 
             m_stmt(std::move(other.m_stmt)),
-            usedValues(std::move(other.usedValues)),
-            freeValues(std::move(other.freeValues))
+            m_cache(std::move(other.m_cache)),
+            m_query(std::move(other.m_query)),
+            m_prepareFlags(other.m_prepareFlags),
+            m_cacheGeneration(other.m_cacheGeneration),
+            m_stepCount(other.m_stepCount),
+            m_metrics(std::move(other.m_metrics)),
+            m_slowQueryLog(std::move(other.m_slowQueryLog)),
+            m_executionTime(other.m_executionTime),
+            convertedValues(std::move(other.convertedValues)),
+            convertedValuesUsed(other.convertedValuesUsed),
+            ownedTexts(std::move(other.ownedTexts))
         {
             other.m_stmt = nullptr;
-
-            assert(other.usedValues.empty());
-            assert(other.freeValues.empty());
         }
 
         Statement& operator = (Statement&& other)
         {
+            close();
+
             m_stmt = other.m_stmt;
             other.m_stmt = nullptr;
 
-            usedValues = std::move(other.usedValues);
-            freeValues = std::move(other.freeValues);
+            m_cache = std::move(other.m_cache);
+            m_query = std::move(other.m_query);
+            m_prepareFlags = other.m_prepareFlags;
+            m_cacheGeneration = other.m_cacheGeneration;
+            m_stepCount = other.m_stepCount;
 
-            assert(other.usedValues.empty());
-            assert(other.freeValues.empty());
+            m_metrics = std::move(other.m_metrics);
+            m_slowQueryLog = std::move(other.m_slowQueryLog);
+            m_executionTime = other.m_executionTime;
+
+            convertedValues = std::move(other.convertedValues);
+            convertedValuesUsed = other.convertedValuesUsed;
+
+            ownedTexts = std::move(other.ownedTexts);
 
             return *this;
         }
@@ -63,8 +105,6 @@ namespace sqlite
         ~Statement()
         {
             close();
-
-            clearFreeValues();
         }
 
         bool Isopen() const
@@ -72,20 +112,46 @@ namespace sqlite
             return m_stmt != nullptr;
         }
         
-        void open(Database& db, const char* query);
+        void open(Database& db, const char* query, unsigned int prepare_flags = 0u);
 
-        void open(Database& db, const std::string& query)
+        void open(Database& db, const std::string& query, unsigned int prepare_flags = 0u)
         {
-            open(db, query.c_str());
+            open(db, query.c_str(), prepare_flags);
         }
 
+        // Takes a prepared statement from the database statement cache or prepares a new one.
+        // The statement is given back to the cache when it is closed.
+        void openCached(Database& db, const std::string& query, unsigned int prepare_flags = 0u);
+
         void close()
         {
             if (Isopen())
             {
-                sqlite3_finalize(m_stmt);
+                if (monitored())
+                {
+                    finishExecution();
+
+                    m_metrics.reset();
+                    m_slowQueryLog.reset();
+                }
+
+                if (std::shared_ptr<StatementCache> cache = m_cache.lock())
+                {
+                    cache->giveBack(m_query, m_prepareFlags, m_stmt, m_cacheGeneration);
+                }
+                else
+                {
+                    sqlite3_finalize(m_stmt);
+                }
 
                 m_stmt = nullptr;
+
+                m_cache.reset();
+                m_query.clear();
+
+                clearConvertedValues();
+
+                ownedTexts.clear();
             }
         }
 
@@ -115,6 +181,28 @@ namespace sqlite
             Checkbind(sqlite3_bind_text(m_stmt, from0To1(col), val, -1, nullptr));
         }
 
+        // SQLite does not need to scan the text for the terminating zero.
+        void bindText(size_t col, std::string_view val, Lifetime lifetime = Lifetime::Static)
+        {
+            sqlite3_destructor_type destructor = SQLITE_STATIC;
+
+            switch (lifetime)
+            {
+                case Lifetime::Static:
+                    break;
+
+                case Lifetime::Transient:
+                    destructor = SQLITE_TRANSIENT;
+                    break;
+
+                case Lifetime::Owned:
+                    val = saveOwnedText(col, val);
+                    break;
+            }
+
+            Checkbind(sqlite3_bind_text64(m_stmt, from0To1(col), val.data(), static_cast<sqlite3_uint64>(val.size()), destructor, SQLITE_UTF8));
+        }
+
         void bindBlob(size_t col, const std::vector<uint8_t>& v)
         {
             Checkbind(sqlite3_bind_blob(m_stmt, from0To1(col), v.data(), static_cast<int>(v.size()), SQLITE_STATIC));
@@ -122,9 +210,11 @@ namespace sqlite
 
         bool Next()
         {
-            const int rc = sqlite3_step(m_stmt);
+            const int rc = step();
+
+            ++m_stepCount;
 
-            clearUsedValues();
+            markConvertedValuesUsed();
             
             switch (rc)
             {
@@ -140,16 +230,18 @@ namespace sqlite
 
         bool tryexec()
         {
-            const int rc = sqlite3_step(m_stmt);
+            const int rc = step();
+
+            ++m_stepCount;
 
-            clearUsedValues();
+            markConvertedValuesUsed();
 
             if (rc != SQLITE_DONE)
             {
                 sqlite3_reset(m_stmt);
 
-                //It does not return SQLITE_CONSTRAINT.
-                if (rc != SQLITE_ERROR)
+                //sqlite3_prepare_v3 statements return SQLITE_CONSTRAINT, but not SQLITE_ERROR.
+                if (rc != SQLITE_ERROR && (rc & 0xff) != SQLITE_CONSTRAINT)
                 {
                     raiseError(rc, "Error while trying to execute a statement.");
                 }
@@ -174,6 +266,13 @@ namespace sqlite
 
         void reset()
         {
+            ++m_stepCount;
+
+            if (monitored())
+            {
+                finishExecution();
+            }
+
             const int rc = sqlite3_reset(m_stmt);
 
             if (rc != SQLITE_OK)
@@ -184,12 +283,20 @@ namespace sqlite
 
         void clearBindings()
         {
+            // The slow query log needs the parameters of the execution.
+            if (monitored())
+            {
+                finishExecution();
+            }
+
             const int rc = sqlite3_clear_bindings(m_stmt);
 
             if (rc != SQLITE_OK)
             {
                 raiseError(rc, "Error while clearing the bindings.");
             }
+
+            clearConvertedValues();
         }
 
         bool isNull(size_t col) const
@@ -246,84 +353,147 @@ namespace sqlite
             return reinterpret_cast<const char *>(sqlite3_column_text(m_stmt, from0To0(col)));
         }
 
+        // The view points to SQLite column buffer and is valid until the statement is stepped or reset.
+        std::string_view textView(size_t col) const
+        {
+            const char* text = textValue(col);
+
+            // sqlite3_column_bytes should be called after sqlite3_column_text.
+            const size_t size = static_cast<size_t>(sqlite3_column_bytes(m_stmt, from0To0(col)));
+
+            return std::string_view(text, size);
+        }
+
         const std::vector<uint8_t> blobValue(size_t col) const
+        {
+            const std::span<const uint8_t> view = blobView(col);
+
+            return std::vector<uint8_t>(view.begin(), view.end());
+        }
+
+        // The view points to SQLite column buffer and is valid until the statement is stepped or reset.
+        std::span<const uint8_t> blobView(size_t col) const
         {
             //When we insert an empty std::vector it becomes Null.
             assert(isNull(col) || isBlob(col));
 
-            const size_t size = static_cast<size_t>(sqlite3_column_bytes(m_stmt, from0To0(col)));
-            
             const uint8_t* buffer = reinterpret_cast<const uint8_t*>(sqlite3_column_blob(m_stmt, from0To0(col)));
 
-            return std::vector<uint8_t>(buffer, buffer + size);
+            const size_t size = static_cast<size_t>(sqlite3_column_bytes(m_stmt, from0To0(col)));
+
+            return std::span<const uint8_t>(buffer, size);
+        }
+
+        // The statement reports its steps to the metrics until it is closed or the metrics are replaced,
+        // without the metrics a step costs only a pointer check.
+        void setMetrics(std::shared_ptr<StatementMetrics> metrics);
+
+        const std::shared_ptr<StatementMetrics>& metrics() const
+        {
+            return m_metrics;
+        }
+
+        // The executions longer than the threshold of the log are reported to it.
+        void setSlowQueryLog(std::shared_ptr<SlowQueryLog> log)
+        {
+            m_slowQueryLog = std::move(log);
+        }
+
+        // The SQL text the statement was prepared with.
+        std::string query() const
+        {
+            return sqlite3_sql(m_stmt);
+        }
+
+        // The SQL text with the bound parameters substituted.
+        std::string expandedQuery() const;
+
+        // It is incremented each time the statement is stepped or reset,
+        // so it can be used to check if the column views are still valid.
+        std::size_t stepCount() const
+        {
+            return m_stepCount;
         }
 
         [[noreturn]] void raiseError(int code, std::string message);
 
         [[noreturn]] void raiseError(std::string message);
 
+        // Keeps a converted value alive until the parameters are bound again,
+        // so it can be bound with SQLITE_STATIC.
         template <class T>
         const T& saveConvertedValue(T val)
         {
-            std::unique_ptr<Any> p_any;
-            
-            if (freeValues.empty())
+            if (convertedValuesUsed)
             {
-                p_any = makeAny(val);
+                clearConvertedValues();
             }
-            else
-            {
-                p_any.reset(freeValues.pop_back());
 
-                p_any->val.emplace<T>(std::move(val));
+            return convertedValues.make<T>(std::move(val));
+        }
+
+    private:
+
+        std::string_view saveOwnedText(size_t col, std::string_view val)
+        {
+            // Allocate the buffers once, because resizing the vector moves the strings
+            // and invalidates the pointers of short strings that are already bound.
+            if (ownedTexts.empty())
+            {
+                ownedTexts.resize(static_cast<size_t>(sqlite3_bind_parameter_count(m_stmt)));
             }
 
-            usedValues.push_back(p_any.release());
+            std::string& text = ownedTexts.at(col);
 
-            T* p_saved_val = std::any_cast<T>(&usedValues.back()->val);
+            text.assign(val);
 
-            return *p_saved_val;
+            return text;
         }
 
-    private:
-
-        struct Any : public awl::quick_link
+        int step()
         {
-            Any(std::any v) : val(v) {}
-            
-            std::any val;
-        };
+            if (!monitored())
+            {
+                return sqlite3_step(m_stmt);
+            }
 
-        using AnyList = awl::quick_list<Any>;
+            return measuredStep();
+        }
 
-        template <class T>
-        std::unique_ptr<Any> makeAny(T val)
+        bool monitored() const
         {
-            return std::make_unique<Any>(std::any(std::move(val)));
+            return m_metrics != nullptr || m_slowQueryLog != nullptr;
         }
 
-        void clearUsedValues()
-        {
-            freeValues.push_back(usedValues);
+        int measuredStep();
+
+        // Called when the statement is done, reset or its bindings are cleared.
+        void finishExecution();
 
-            assert(usedValues.empty());
+        // Adds sqlite3_stmt_status counters to the metrics and zeroes them.
+        void collectStatus();
+
+        // SQLite reads the bound values on every step, so they are destroyed
+        // only when the statement is bound again, its bindings are cleared or it is closed.
+        void markConvertedValuesUsed()
+        {
+            convertedValuesUsed = true;
         }
 
-        void clearFreeValues()
+        void clearConvertedValues()
         {
-            assert(usedValues.empty());
+            convertedValues.reset();
 
-            while (!freeValues.empty())
-            {
-                delete freeValues.pop_back();
-            }
+            convertedValuesUsed = false;
         }
 
         void Internalexec(bool auto_reset)
         {
-            const int rc = sqlite3_step(m_stmt);
+            const int rc = step();
+
+            ++m_stepCount;
 
-            clearUsedValues();
+            markConvertedValuesUsed();
 
             if (rc != SQLITE_DONE)
             {
@@ -390,7 +560,27 @@ namespace sqlite
 
         sqlite3_stmt * m_stmt = nullptr;
 
-        AnyList usedValues;
-        AnyList freeValues;
+        // Not empty if the statement was taken from the cache.
+        std::weak_ptr<StatementCache> m_cache;
+        std::string m_query;
+        unsigned int m_prepareFlags = 0u;
+        std::size_t m_cacheGeneration = 0u;
+
+        std::size_t m_stepCount = 0u;
+
+        std::shared_ptr<StatementMetrics> m_metrics;
+
+        std::shared_ptr<SlowQueryLog> m_slowQueryLog;
+
+        // The time of the steps of the current execution.
+        std::chrono::nanoseconds m_executionTime{};
+
+        // The values saved with saveConvertedValue, they are destroyed when the statement is bound again after a step.
+        BumpArena convertedValues;
+
+        bool convertedValuesUsed = false;
+
+        // Lifetime::Owned texts indexed by the parameter.
+        std::vector<std::string> ownedTexts;
     };
 }
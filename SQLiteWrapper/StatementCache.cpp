@@ -0,0 +1,89 @@
+#include "SQLiteWrapper/StatementCache.h"
+
+#include <cassert>
+
+using namespace sqlite;
+
+sqlite3_stmt* StatementCache::checkout(const std::string& query, unsigned int prepare_flags)
+{
+    auto i = m_map.find(Key(query, prepare_flags));
+
+    if (i == m_map.end())
+    {
+        ++m_missCount;
+
+        return nullptr;
+    }
+
+    ++m_hitCount;
+
+    List::iterator list_i = i->second;
+
+    sqlite3_stmt* stmt = list_i->second;
+
+    m_map.erase(i);
+    m_list.erase(list_i);
+
+    return stmt;
+}
+
+void StatementCache::giveBack(const std::string& query, unsigned int prepare_flags, sqlite3_stmt* stmt, std::size_t generation)
+{
+    assert(stmt != nullptr);
+
+    if (generation != m_generation || m_capacity == 0u)
+    {
+        sqlite3_finalize(stmt);
+
+        return;
+    }
+
+    // If the statement failed sqlite3_reset returns an error, but we ignore it.
+    sqlite3_reset(stmt);
+    sqlite3_clear_bindings(stmt);
+
+    Key key(query, prepare_flags);
+
+    m_list.emplace_front(key, stmt);
+
+    m_map.emplace(std::move(key), m_list.begin());
+
+    shrink();
+}
+
+void StatementCache::clear()
+{
+    for (Entry& entry : m_list)
+    {
+        sqlite3_finalize(entry.second);
+    }
+
+    m_map.clear();
+    m_list.clear();
+
+    ++m_generation;
+}
+
+void StatementCache::shrink()
+{
+    while (m_list.size() > m_capacity)
+    {
+        List::iterator last = std::prev(m_list.end());
+
+        auto range = m_map.equal_range(last->first);
+
+        for (auto i = range.first; i != range.second; ++i)
+        {
+            if (i->second == last)
+            {
+                m_map.erase(i);
+
+                break;
+            }
+        }
+
+        sqlite3_finalize(last->second);
+
+        m_list.erase(last);
+    }
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "sqlite3.h"
+
+#include <string>
+#include <list>
+#include <unordered_map>
+#include <utility>
+#include <functional>
+#include <cstddef>
+
+namespace sqlite
+{
+    // LRU cache of prepared statements keyed by SQL text and prepare flags,
+    // because the flags, for example SQLITE_PREPARE_PERSISTENT, are a property of the prepared statement.
+    // A statement is checked out while it is in use and is given back when it is closed,
+    // so the same sqlite3_stmt is never shared by two Statement objects.
+    class StatementCache
+    {
+    public:
+
+        static constexpr std::size_t defaultCapacity = 64u;
+
+        explicit StatementCache(std::size_t capacity = defaultCapacity) : m_capacity(capacity) {}
+
+        StatementCache(const StatementCache&) = delete;
+
+        StatementCache& operator = (const StatementCache&) = delete;
+
+        ~StatementCache()
+        {
+            clear();
+        }
+
+        // Returns nullptr if there is no idle statement with the given SQL text and prepare flags.
+        sqlite3_stmt* checkout(const std::string& query, unsigned int prepare_flags);
+
+        // Makes the statement available for checkout. The statement is finalized
+        // if it was checked out before the cache was cleared.
+        void giveBack(const std::string& query, unsigned int prepare_flags, sqlite3_stmt* stmt, std::size_t generation);
+
+        // Finalizes idle statements, the statements that are checked out
+        // are finalized when they are given back.
+        void clear();
+
+        std::size_t generation() const
+        {
+            return m_generation;
+        }
+
+        std::size_t hitCount() const
+        {
+            return m_hitCount;
+        }
+
+        std::size_t missCount() const
+        {
+            return m_missCount;
+        }
+
+        // The number of idle statements.
+        std::size_t size() const
+        {
+            return m_list.size();
+        }
+
+        std::size_t capacity() const
+        {
+            return m_capacity;
+        }
+
+        void setCapacity(std::size_t capacity)
+        {
+            m_capacity = capacity;
+
+            shrink();
+        }
+
+    private:
+
+        using Key = std::pair<std::string, unsigned int>;
+
+        struct KeyHash
+        {
+            std::size_t operator()(const Key& key) const
+            {
+                return std::hash<std::string>()(key.first) ^ std::hash<unsigned int>()(key.second);
+            }
+        };
+
+        using Entry = std::pair<Key, sqlite3_stmt*>;
+
+        using List = std::list<Entry>;
+
+        void shrink();
+
+        // The most recently used statements are at the front.
+        List m_list;
+
+        // Several Set objects can prepare the same query, so the keys are not unique.
+        std::unordered_multimap<Key, List::iterator, KeyHash> m_map;
+
+        std::size_t m_capacity;
+
+        std::size_t m_generation = 0u;
+
+        std::size_t m_hitCount = 0u;
+        std::size_t m_missCount = 0u;
+    };
+}
@@ -0,0 +1,147 @@
+#include "SQLiteWrapper/StatementMetrics.h"
+
+#include <sstream>
+#include <iomanip>
+
+using namespace sqlite;
+
+namespace
+{
+    double toMilliseconds(std::chrono::nanoseconds d)
+    {
+        return std::chrono::duration<double, std::milli>(d).count();
+    }
+
+    void writeJsonString(std::ostream& out, const std::string& s)
+    {
+        out << '"';
+
+        for (const char c : s)
+        {
+            switch (c)
+            {
+                case '"':
+                    out << "\\\"";
+                    break;
+
+                case '\\':
+                    out << "\\\\";
+                    break;
+
+                case '\n':
+                    out << "\\n";
+                    break;
+
+                case '\r':
+                    out << "\\r";
+                    break;
+
+                case '\t':
+                    out << "\\t";
+                    break;
+
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20)
+                    {
+                        out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c) << std::dec << std::setfill(' ');
+                    }
+                    else
+                    {
+                        out << c;
+                    }
+            }
+        }
+
+        out << '"';
+    }
+}
+
+std::shared_ptr<StatementMetrics> MetricsRegistry::find(const std::string& label, const std::string& query)
+{
+    std::shared_ptr<StatementMetrics>& p_metrics = m_map[std::make_pair(label, query)];
+
+    if (p_metrics == nullptr)
+    {
+        p_metrics = std::make_shared<StatementMetrics>();
+
+        p_metrics->label = label;
+        p_metrics->query = query;
+    }
+
+    return p_metrics;
+}
+
+void MetricsRegistry::reset()
+{
+    for (auto& [key, p_metrics] : m_map)
+    {
+        StatementMetrics& m = *p_metrics;
+
+        m = StatementMetrics{ std::move(m.label), std::move(m.query) };
+    }
+}
+
+void MetricsRegistry::writeText(std::ostream& out) const
+{
+    for (const auto& [key, p_metrics] : m_map)
+    {
+        const StatementMetrics& m = *p_metrics;
+
+        out << m.label << ": calls=" << m.callCount << " steps=" << m.stepCount << " rows=" << m.rowCount <<
+            std::fixed << std::setprecision(3) <<
+            " total_ms=" << toMilliseconds(m.totalStepTime) << " max_ms=" << toMilliseconds(m.maxStepTime) <<
+            " fullscan_steps=" << m.fullscanStepCount << " sorts=" << m.sortCount << " autoindexes=" << m.autoindexCount <<
+            " vm_steps=" << m.vmStepCount << " reprepares=" << m.reprepareCount <<
+            " sql=" << m.query << "\n";
+    }
+}
+
+void MetricsRegistry::writeJson(std::ostream& out) const
+{
+    out << "[";
+
+    bool first = true;
+
+    for (const auto& [key, p_metrics] : m_map)
+    {
+        const StatementMetrics& m = *p_metrics;
+
+        if (!first)
+        {
+            out << ",";
+        }
+
+        first = false;
+
+        out << "{\"label\":";
+        writeJsonString(out, m.label);
+
+        out << ",\"sql\":";
+        writeJsonString(out, m.query);
+
+        out << ",\"calls\":" << m.callCount << ",\"steps\":" << m.stepCount << ",\"rows\":" << m.rowCount <<
+            ",\"total_ns\":" << m.totalStepTime.count() << ",\"max_ns\":" << m.maxStepTime.count() <<
+            ",\"fullscan_steps\":" << m.fullscanStepCount << ",\"sorts\":" << m.sortCount << ",\"autoindexes\":" << m.autoindexCount <<
+            ",\"vm_steps\":" << m.vmStepCount << ",\"reprepares\":" << m.reprepareCount << "}";
+    }
+
+    out << "]";
+}
+
+std::string MetricsRegistry::text() const
+{
+    std::ostringstream out;
+
+    writeText(out);
+
+    return out.str();
+}
+
+std::string MetricsRegistry::json() const
+{
+    std::ostringstream out;
+
+    writeJson(out);
+
+    return out.str();
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <memory>
+#include <map>
+#include <utility>
+#include <ostream>
+
+namespace sqlite
+{
+    // The counters accumulated by the statements with the same label and SQL text.
+    struct StatementMetrics
+    {
+        std::string label;
+        std::string query;
+
+        // The number of the executions, a new execution starts with the first step after a reset.
+        uint64_t callCount = 0u;
+        uint64_t stepCount = 0u;
+        uint64_t rowCount = 0u;
+
+        std::chrono::nanoseconds totalStepTime{};
+        std::chrono::nanoseconds maxStepTime{};
+
+        // sqlite3_stmt_status counters.
+        uint64_t fullscanStepCount = 0u;
+        uint64_t sortCount = 0u;
+        uint64_t autoindexCount = 0u;
+        uint64_t vmStepCount = 0u;
+        uint64_t reprepareCount = 0u;
+    };
+
+    // The metrics of the statements of a connection, it is used by one thread at a time like the connection.
+    class MetricsRegistry
+    {
+    public:
+
+        using Map = std::map<std::pair<std::string, std::string>, std::shared_ptr<StatementMetrics>>;
+
+        // Returns the metrics shared by all the statements with the given label and query.
+        std::shared_ptr<StatementMetrics> find(const std::string& label, const std::string& query);
+
+        // Zeroes the counters, the statements keep reporting to the same entries.
+        void reset();
+
+        // Ordered by the label and the query.
+        const Map& entries() const
+        {
+            return m_map;
+        }
+
+        void writeText(std::ostream& out) const;
+
+        void writeJson(std::ostream& out) const;
+
+        std::string text() const;
+
+        std::string json() const;
+
+    private:
+
+        Map m_map;
+    };
+}
@@ -3,6 +3,8 @@
 #include "SQLiteWrapper/Helpers.h"
 
 #include <sstream>
+#include <string_view>
+#include <span>
 
 namespace sqlite
 {
@@ -33,18 +35,19 @@ namespace sqlite
             m_out << "(" << std::endl;
         }
 
+        // A key is a field pointer or a tuple of field pointers to a field of a nested structure.
         template <typename... Keys>
-        void setPrimaryKey(Keys Struct::*...fieldPtr)
+        void setPrimaryKey(const Keys&... key_paths)
         {
-            (m_primaryKeyColumns.push_back(helpers::findFieldIndex(fieldPtr)), ...);
+            (m_primaryKeyColumns.push_back(helpers::findPathIndex<Struct>(key_paths)), ...);
         }
         
         template <typename... Keys>
-        void setPrimaryKeyTuple(std::tuple<Keys Struct::*...> id_ptrs)
+        void setPrimaryKeyTuple(const std::tuple<Keys...>& key_paths)
         {
-            awl::for_each(id_ptrs, [this](auto& id_ptr)
+            awl::for_each(key_paths, [this](auto& key_path)
             {
-                m_primaryKeyColumns.push_back(helpers::findFieldIndex(id_ptr));
+                m_primaryKeyColumns.push_back(helpers::findPathIndex<Struct>(key_path));
             });
         }
 
@@ -77,9 +80,9 @@ namespace sqlite
 
             using DataType = helpers::RemoveOptionalT<FieldType>;
             
-            constexpr bool is_text = std::is_same_v<std::string, DataType>;
+            constexpr bool is_text = std::is_same_v<std::string, DataType> || std::is_same_v<std::string_view, DataType>;
 
-            constexpr bool is_blob = std::is_same_v<DataType, std::vector<uint8_t>>;
+            constexpr bool is_blob = std::is_same_v<DataType, std::vector<uint8_t>> || std::is_same_v<DataType, std::span<const uint8_t>>;
 
             if constexpr (is_text)
             {
@@ -141,11 +144,9 @@ namespace sqlite
         {
             //Remove rowId from primary key.
             m_primaryKeyColumns.erase(
-                std::remove_if(m_primaryKeyColumns.begin(), m_primaryKeyColumns.end(), [](size_t field_index)
+                std::remove_if(m_primaryKeyColumns.begin(), m_primaryKeyColumns.end(), [](size_t column_index)
                 {
-                    const auto& memberNames = Struct::member_names();
-
-                    const std::string& name = memberNames[field_index];
+                    const std::string& name = helpers::columnNames<Struct>()[column_index];
 
                     return name == rowIdFieldName;
                 }),
@@ -159,7 +160,7 @@ namespace sqlite
 
                 bool firstPK = true;
 
-                for (const size_t fieldIndex : m_primaryKeyColumns)
+                for (const size_t columnIndex : m_primaryKeyColumns)
                 {
                     if (firstPK)
                     {
@@ -170,11 +171,7 @@ namespace sqlite
                         m_out << " ,";
                     }
 
-                    const auto& memberNames = Struct::member_names();
-
-                    const std::string& name = memberNames[fieldIndex];
-
-                    m_out << name;
+                    m_out << helpers::columnNames<Struct>()[columnIndex];
                 }
 
                 m_out << ")";
@@ -252,6 +249,7 @@ namespace sqlite
 
         std::string m_foreignKeyClause;
 
+        // Column indices.
         std::vector<size_t> m_primaryKeyColumns;
         
         std::array<std::string, helpers::fieldCount<Struct>()> m_columnConstraints;
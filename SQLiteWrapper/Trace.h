@@ -0,0 +1,38 @@
+#pragma once
+
+#include "sqlite3.h"
+
+#include "Awl/EnumTraits.h"
+#include "Awl/BitMap.h"
+
+#include <chrono>
+#include <functional>
+
+namespace sqlite
+{
+    // The values are the bit indices of SQLITE_TRACE_STMT, SQLITE_TRACE_PROFILE, SQLITE_TRACE_ROW and SQLITE_TRACE_CLOSE.
+    AWL_SEQUENTIAL_ENUM(TraceKind, Statement, Profile, Row, Close)
+}
+
+AWL_ENUM_TRAITS(sqlite, TraceKind)
+
+namespace sqlite
+{
+    using TraceMask = awl::bitmap<TraceKind>;
+
+    struct TraceEvent
+    {
+        TraceKind kind;
+
+        // Statement, Profile and Row.
+        sqlite3_stmt* stmt = nullptr;
+
+        // Statement: the SQL text when the statement starts or a comment when a trigger starts.
+        const char* sql = nullptr;
+
+        // Profile: the time of the execution.
+        std::chrono::nanoseconds time{};
+    };
+
+    using TraceCallback = std::function<void(const TraceEvent&)>;
+}
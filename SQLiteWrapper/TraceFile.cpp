@@ -0,0 +1,87 @@
+#include "SQLiteWrapper/TraceFile.h"
+#include "SQLiteWrapper/Exception.h"
+
+using namespace sqlite;
+
+namespace
+{
+    template <class T>
+    void writeValue(std::ostream& out, const T& val)
+    {
+        out.write(reinterpret_cast<const char*>(&val), sizeof(val));
+    }
+
+    template <class T>
+    bool readValue(std::istream& in, T& val)
+    {
+        return static_cast<bool>(in.read(reinterpret_cast<char*>(&val), sizeof(val)));
+    }
+}
+
+uint64_t sqlite::hashQuery(std::string_view query)
+{
+    uint64_t hash = 14695981039346656037ull;
+
+    for (const char c : query)
+    {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ull;
+    }
+
+    return hash;
+}
+
+void sqlite::writeTraceHeader(std::ostream& out)
+{
+    out.write(traceFileSignature.data(), traceFileSignature.size());
+}
+
+void sqlite::writeTraceSample(std::ostream& out, const TraceSample& sample)
+{
+    writeValue(out, sample.time);
+    writeValue(out, sample.duration);
+    writeValue(out, sample.queryHash);
+    writeValue(out, sample.textSize);
+
+    out.write(sample.text.data(), sample.textSize);
+}
+
+void sqlite::readTraceHeader(std::istream& in)
+{
+    std::string signature(traceFileSignature.size(), '\0');
+
+    if (!in.read(signature.data(), signature.size()) || signature != traceFileSignature)
+    {
+        throw SQLiteException("Not a trace file.");
+    }
+}
+
+bool sqlite::readTraceRecord(std::istream& in, TraceRecord& record)
+{
+    int64_t time;
+
+    if (!readValue(in, time))
+    {
+        return false;
+    }
+
+    int64_t duration;
+    uint32_t text_size;
+
+    if (!readValue(in, duration) || !readValue(in, record.queryHash) || !readValue(in, text_size) || text_size > TraceSample::maxTextSize)
+    {
+        throw SQLiteException("A truncated or corrupted trace record.");
+    }
+
+    record.time = std::chrono::system_clock::time_point(std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds(time)));
+    record.duration = std::chrono::nanoseconds(duration);
+
+    record.text.resize(text_size);
+
+    if (!in.read(record.text.data(), text_size))
+    {
+        throw SQLiteException("A truncated trace record.");
+    }
+
+    return true;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+namespace sqlite
+{
+    // A trace file starts with traceFileSignature followed by the records in the native byte order:
+    // int64 time (nanoseconds since the epoch), int64 duration (nanoseconds), uint64 query hash,
+    // uint32 text size and the text. The text is written with the first record of a query only.
+    constexpr std::string_view traceFileSignature = "SQLWTRC1";
+
+    // A fixed-size record of a profiled execution.
+    struct TraceSample
+    {
+        static constexpr std::size_t maxTextSize = 240;
+
+        int64_t time;
+
+        int64_t duration;
+
+        uint64_t queryHash;
+
+        // Zero if the text of the query has been already written.
+        uint32_t textSize;
+
+        // The text is truncated to maxTextSize.
+        std::array<char, maxTextSize> text;
+    };
+
+    struct TraceRecord
+    {
+        std::chrono::system_clock::time_point time;
+
+        std::chrono::nanoseconds duration;
+
+        uint64_t queryHash;
+
+        // Empty if the text of the query is in a previous record.
+        std::string text;
+    };
+
+    // FNV-1a, it does not depend on the standard library implementation, so the hashes of different files match.
+    uint64_t hashQuery(std::string_view query);
+
+    void writeTraceHeader(std::ostream& out);
+
+    void writeTraceSample(std::ostream& out, const TraceSample& sample);
+
+    // Throws if the stream does not start with the signature.
+    void readTraceHeader(std::istream& in);
+
+    // Returns false at the end of the stream.
+    bool readTraceRecord(std::istream& in, TraceRecord& record);
+}
@@ -4,6 +4,7 @@
 #include "SQLiteWrapper/QueryBuilder.h"
 #include "SQLiteWrapper/Statement.h"
 #include "SQLiteWrapper/Bind.h"
+#include "SQLiteWrapper/BindPlan.h"
 #include "SQLiteWrapper/Get.h"
 
 namespace sqlite
@@ -14,7 +15,8 @@ namespace sqlite
     public:
 
         Updater(Database& db, Statement s, IndexFilter id_indices, IndexFilter value_indices) :
-            m_db(db), m_s(std::move(s)), m_idIndices(id_indices), m_valueIndices(value_indices)
+            m_db(db), m_s(std::move(s)), m_idIndices(id_indices), m_valueIndices(value_indices),
+            m_bindPlan(makeBindPlan(m_idIndices, m_valueIndices))
         {
         }
 
@@ -28,13 +30,7 @@ namespace sqlite
 
         void update(const Struct& val)
         {
-            helpers::forEachFieldValue(val, [this](auto& field, auto field_index)
-            {
-                if (m_idIndices.contains(field_index) || m_valueIndices.contains(field_index))
-                {
-                    sqlite::bind(m_s, field_index, field);
-                }
-            });
+            m_bindPlan.bind(m_s, val);
 
             exec();
         }
@@ -81,6 +77,21 @@ namespace sqlite
 
     private:
 
+        static BindPlan<Struct> makeBindPlan(const IndexFilter& id_indices, const IndexFilter& value_indices)
+        {
+            IndexFilter filter = value_indices;
+
+            for (size_t i : id_indices)
+            {
+                if (!filter.contains(i))
+                {
+                    filter.insert(i);
+                }
+            }
+
+            return BindPlan<Struct>(filter);
+        }
+
         void exec()
         {
             m_s.exec();
@@ -95,5 +106,7 @@ namespace sqlite
         const IndexFilter m_idIndices;
 
         const IndexFilter m_valueIndices;
+
+        BindPlan<Struct> m_bindPlan;
     };
 }
@@ -0,0 +1,166 @@
+#include "DbContainer.h"
+#include "ExchangeModel.h"
+#include "Tests/TableHelper.h"
+
+#include "SQLiteWrapper/Set.h"
+#include "SQLiteWrapper/AsyncWriter.h"
+
+#include "Awl/StopWatch.h"
+
+#include <vector>
+#include <future>
+#include <atomic>
+#include <chrono>
+
+using namespace swtest;
+using namespace exchange::data;
+
+namespace
+{
+    Market MakeMarket(size_t i)
+    {
+        return Market{ {}, "m" + std::to_string(i), {} };
+    }
+}
+
+AWL_TEST(AsyncWriter)
+{
+    DbContainer c(context);
+
+    auto set = makeSet(c.m_db, "markets", std::make_tuple(&Market::id));
+
+    const size_t row_count = 100;
+
+    const Precision precision{ 1, 2, 3, 4 };
+
+    std::atomic<size_t> updated_count = 0;
+
+    {
+        sqlite::AsyncWriter writer(c.m_db, std::chrono::milliseconds(1), 10);
+
+        std::vector<std::future<void>> futures;
+
+        for (size_t i = 0; i < row_count; ++i)
+        {
+            futures.push_back(writer.insert(set, MakeMarket(i)));
+        }
+
+        // The failed insert does not roll back the other commands of its transaction.
+        std::future<void> duplicate_future = writer.insert(set, MakeMarket(0));
+
+        for (size_t i = 0; i < row_count; i += 2)
+        {
+            Market m = MakeMarket(i);
+
+            m.precision = precision;
+
+            writer.update(set, m, [&updated_count](std::exception_ptr error)
+            {
+                if (!error)
+                {
+                    ++updated_count;
+                }
+            });
+        }
+
+        std::future<void> delete_future = writer.deleteElement(set, std::make_tuple(MakeMarket(1).id));
+
+        for (std::future<void>& future : futures)
+        {
+            future.get();
+        }
+
+        bool failed = false;
+
+        try
+        {
+            duplicate_future.get();
+        }
+        catch (const sqlite::SQLiteException&)
+        {
+            failed = true;
+        }
+
+        AWL_ASSERT(failed);
+
+        delete_future.get();
+
+        writer.stop();
+
+        AWL_ASSERT(writer.commitCount() != 0u);
+    }
+
+    AWL_ASSERT_EQUAL(row_count / 2, updated_count.load());
+
+    for (size_t i = 0; i < row_count; ++i)
+    {
+        Market m;
+
+        const bool exists = set.find(MakeMarket(i).id, m);
+
+        AWL_ASSERT_EQUAL(i != 1, exists);
+
+        if (exists)
+        {
+            AWL_ASSERT(m.precision == (i % 2 == 0 ? precision : Precision{}));
+        }
+    }
+}
+
+//--output all --filter AsyncWriterBenchmark_Test --row_count 100000 --synchronous FULL --journal_mode WAL
+AWL_TEST(AsyncWriterBenchmark)
+{
+    AWL_ATTRIBUTE(size_t, row_count, 100);
+
+    DbContainer c(context);
+
+    auto set = makeSet(c.m_db, "markets", std::make_tuple(&Market::id));
+
+    size_t row_index = 0;
+
+    // Each row is committed separately.
+    {
+        awl::StopWatch sw;
+
+        for (size_t i = 0; i < row_count; ++i)
+        {
+            set.insert(MakeMarket(row_index++));
+        }
+
+        PrintSpeed(context, _T("synchronous"), sw, row_count, _T("rows"));
+    }
+
+    for (const auto window : { std::chrono::microseconds(0), std::chrono::microseconds(100), std::chrono::microseconds(1000), std::chrono::microseconds(10000) })
+    {
+        awl::StopWatch sw;
+
+        size_t commit_count = 0;
+
+        {
+            sqlite::AsyncWriter writer(c.m_db, window);
+
+            std::future<void> last_future;
+
+            for (size_t i = 0; i < row_count; ++i)
+            {
+                last_future = writer.insert(set, MakeMarket(row_index++));
+            }
+
+            // The commands are committed in order.
+            last_future.get();
+
+            commit_count = writer.commitCount();
+        }
+
+        PrintSpeed(context, awl::format() << _T("window ") << window.count() << _T("us, ") << commit_count << _T(" commits"), sw, row_count, _T("rows"));
+    }
+
+    size_t count = 0;
+
+    for ([[maybe_unused]] const Market& m : set)
+    {
+        ++count;
+    }
+
+    AWL_ASSERT_EQUAL(row_index, count);
+}
@@ -9,6 +9,7 @@
 #include "Awl/IntRange.h"
 
 #include <string>
+#include <optional>
 
 using namespace swtest;
 
@@ -34,6 +35,27 @@ namespace
         { 3, "ETH_USDT", {7u, 8u, 9u} }
     };
 
+    // Points to the column buffers of the current row.
+    struct BotView
+    {
+        int id;
+        std::string_view name;
+        std::span<const uint8_t> state;
+
+        AWL_REFLECT(id, name, state)
+    };
+
+    static_assert(std::input_iterator<sqlite::Iterator<BotView>>);
+
+    static_assert(!sqlite::helpers::hasViews<Bot>());
+    static_assert(sqlite::helpers::hasViews<BotView>());
+    static_assert(sqlite::helpers::hasViews<std::tuple<int, std::optional<std::string_view>>>());
+
+    bool equalView(const Bot& bot, const BotView& view)
+    {
+        return bot.id == view.id && bot.name == view.name && std::ranges::equal(bot.state, view.state);
+    }
+
     const Bot bot1{ 1, "DASH_USDT", {1u, 2u, 3u, 4u, 5u, 6u} };
     const Bot bot2{ 2, "XRP_USDT", {1u, 2u} };
 }
@@ -69,10 +91,27 @@ AWL_TEST(Blob)
         AWL_ASSERT(std::ranges::equal(bots, actual_bots));
     }
 
+    //An owning record stays valid when the statement moves on, the iterators step the same statement.
+    {
+        auto i = set.begin();
+
+        auto j = set.begin();
+
+        AWL_ASSERT(*i == bots[0]);
+        AWL_ASSERT(*j == bots[1]);
+    }
+
     //std::ranges tests
 
     AWL_ASSERT(std::ranges::equal(bots, set));
 
+    //Zero-copy views
+    {
+        sqlite::Statement st(c.db(), sqlite::buildTrivialSelectQuery<BotView>(table_name));
+
+        AWL_ASSERT(std::ranges::equal(bots, sqlite::make_range<BotView>(st), equalView));
+    }
+
     //Find/Update tests
 
     for (const Bot& bot : bots)
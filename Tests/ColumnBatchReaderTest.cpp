@@ -0,0 +1,65 @@
+#include "DbContainer.h"
+#include "ExchangeModel.h"
+#include "Tests/TableHelper.h"
+
+#include "SQLiteWrapper/Set.h"
+#include "SQLiteWrapper/ColumnBatchReader.h"
+
+#include <vector>
+#include <string>
+
+using namespace swtest;
+using namespace exchange::data;
+
+AWL_TEST(ColumnBatchReader)
+{
+    AWL_ATTRIBUTE(size_t, row_count, 10);
+    AWL_ATTRIBUTE(size_t, batch_size, 3);
+
+    DbContainer c(context);
+
+    auto set = makeSet(c.m_db, "markets", std::make_tuple(&Market::id));
+
+    std::vector<Market> markets;
+
+    for (size_t i = 0; i < row_count; ++i)
+    {
+        const int n = static_cast<int>(i);
+
+        Market m{ { { n, n + 1 }, { n + 2, n + 3 }, { n + 4, n + 5 } }, "m" + std::to_string(i), { static_cast<uint8_t>(i), 2, 3, 4 } };
+
+        set.insert(m);
+
+        markets.push_back(m);
+    }
+
+    // The rows are read in the rowid order, that is the insertion order.
+    size_t row_index = 0;
+
+    {
+        auto reader = set.readColumns(batch_size);
+
+        // The nested structures are flattened.
+        static_assert(decltype(reader)::columnCount == 11);
+
+        while (const size_t size = reader.next())
+        {
+            AWL_ASSERT(size <= batch_size);
+            AWL_ASSERT_EQUAL(size, reader.column<0>().size());
+
+            for (size_t i = 0; i < size; ++i, ++row_index)
+            {
+                const Market& m = markets[row_index];
+
+                AWL_ASSERT_EQUAL(m.limits.amount.min, reader.column<0>()[i]);
+                AWL_ASSERT_EQUAL(m.limits.cost.max, reader.column<5>()[i]);
+                AWL_ASSERT(m.id == reader.column<6>()[i]);
+                AWL_ASSERT_EQUAL(m.precision.base, reader.column<7>()[i]);
+            }
+        }
+
+        AWL_ASSERT_EQUAL(0u, reader.next());
+    }
+
+    AWL_ASSERT_EQUAL(row_count, row_index);
+}
@@ -0,0 +1,261 @@
+#include "DbContainer.h"
+#include "SQLiteWrapper/Bind.h"
+#include "SQLiteWrapper/Get.h"
+#include "SQLiteWrapper/BumpArena.h"
+
+#include "Awl/StopWatch.h"
+
+#include <any>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace swtest;
+
+namespace
+{
+    // It is stored as "BASE/QUOTE" text.
+    struct Symbol
+    {
+        std::string base;
+        std::string quote;
+    };
+
+    const char create_query[] = "CREATE TABLE symbols (name TEXT, price INTEGER);";
+    const char insert_query[] = "INSERT INTO symbols (name, price) VALUES (?1, ?2);";
+    const char select_query[] = "SELECT name, price FROM symbols";
+
+    // A test-local model of the old Statement::saveConvertedValue, a list of the nodes containing std::any,
+    // it is not the removed code itself, so the benchmark compares the allocation patterns only.
+    class AnyValues
+    {
+    public:
+
+        template <class T>
+        const T& save(T val)
+        {
+            std::unique_ptr<std::any> p_any;
+
+            if (freeValues.empty())
+            {
+                p_any = std::make_unique<std::any>(std::move(val));
+            }
+            else
+            {
+                p_any = std::move(freeValues.back());
+
+                freeValues.pop_back();
+
+                p_any->emplace<T>(std::move(val));
+            }
+
+            usedValues.push_back(std::move(p_any));
+
+            return *std::any_cast<T>(usedValues.back().get());
+        }
+
+        void clear()
+        {
+            for (auto& p : usedValues)
+            {
+                freeValues.push_back(std::move(p));
+            }
+
+            usedValues.clear();
+        }
+
+    private:
+
+        std::vector<std::unique_ptr<std::any>> usedValues;
+        std::vector<std::unique_ptr<std::any>> freeValues;
+    };
+
+    std::string makeText(const Symbol& val)
+    {
+        return val.base + "/" + val.quote;
+    }
+}
+
+namespace sqlite
+{
+    inline void bind(Statement& st, size_t col, const Symbol& val)
+    {
+        const std::string& text = st.saveConvertedValue(makeText(val));
+
+        st.bindText(col, std::string_view(text));
+    }
+}
+
+AWL_TEST(ConvertedValue)
+{
+    DbContainer c(context);
+
+    c.m_db->exec(create_query);
+
+    const std::vector<Symbol> symbols = { { "BTC", "USDT" }, { "TRX", "USDT" }, { "ETH", "BTC" } };
+
+    {
+        sqlite::Statement insert_statement(*c.m_db, insert_query);
+
+        int64_t price = 0;
+
+        for (const Symbol& symbol : symbols)
+        {
+            sqlite::bind(insert_statement, 0, symbol);
+            sqlite::bind(insert_statement, 1, price++);
+
+            insert_statement.exec();
+        }
+    }
+
+    {
+        sqlite::Statement select_statement(*c.m_db, select_query);
+
+        for (const Symbol& symbol : symbols)
+        {
+            AWL_ASSERT(select_statement.Next());
+
+            std::string name;
+            sqlite::get(select_statement, 0, name);
+            AWL_ASSERT(name == makeText(symbol));
+        }
+
+        AWL_ASSERT(!select_statement.Next());
+    }
+}
+
+AWL_TEST(ConvertedValueParameter)
+{
+    DbContainer c(context);
+
+    c.m_db->exec(create_query);
+
+    // Longer than the small string buffer, so the text is on the heap.
+    const Symbol symbol{ "A_VERY_LONG_BASE_CURRENCY_NAME", "A_VERY_LONG_QUOTE_CURRENCY_NAME" };
+
+    const size_t row_count = 5;
+
+    {
+        sqlite::Statement insert_statement(*c.m_db, insert_query);
+
+        for (size_t i = 0; i < row_count; ++i)
+        {
+            sqlite::bind(insert_statement, 0, symbol);
+            sqlite::bind(insert_statement, 1, static_cast<int64_t>(i));
+
+            insert_statement.exec();
+        }
+    }
+
+    sqlite::Statement select_statement(*c.m_db, std::string(select_query) + " WHERE name=?1");
+
+    // The converted parameter is read by SQLite on every step and after the statement is reset.
+    for (size_t iteration = 0; iteration < 2; ++iteration)
+    {
+        if (iteration == 0)
+        {
+            sqlite::bind(select_statement, 0, symbol);
+        }
+
+        size_t count = 0;
+
+        while (select_statement.Next())
+        {
+            std::string name;
+            sqlite::get(select_statement, 0, name);
+            AWL_ASSERT(name == makeText(symbol));
+
+            ++count;
+        }
+
+        AWL_ASSERT_EQUAL(row_count, count);
+
+        select_statement.reset();
+    }
+}
+
+AWL_TEST(BumpArena)
+{
+    AWL_UNUSED_CONTEXT;
+
+    sqlite::BumpArena arena(16);
+
+    for (size_t iteration = 0; iteration < 3; ++iteration)
+    {
+        std::vector<const std::string*> texts;
+
+        for (size_t i = 0; i < 100; ++i)
+        {
+            arena.make<char>('a');
+
+            texts.push_back(&arena.make<std::string>(std::to_string(i)));
+
+            arena.make<double>(static_cast<double>(i));
+        }
+
+        // Growing the arena does not move the objects.
+        for (size_t i = 0; i < texts.size(); ++i)
+        {
+            AWL_ASSERT(*texts[i] == std::to_string(i));
+        }
+
+        const size_t capacity = arena.capacity();
+
+        arena.reset();
+
+        AWL_ASSERT_EQUAL(capacity, arena.capacity());
+    }
+}
+
+//--output all --filter ConvertedValueBenchmark_Test --iteration_count 1000000
+AWL_TEST(ConvertedValueBenchmark)
+{
+    AWL_ATTRIBUTE(size_t, iteration_count, 1000);
+
+    DbContainer c(context);
+
+    // The statement is stepped without touching any table.
+    sqlite::Statement st(*c.m_db, "SELECT ?1, ?2, ?3;");
+
+    const Symbol symbol{ "BTC", "USDT" };
+
+    {
+        AnyValues values;
+
+        awl::StopWatch sw;
+
+        for (size_t i = 0; i < iteration_count; ++i)
+        {
+            for (size_t col = 0; col < 3; ++col)
+            {
+                st.bindText(col, std::string_view(values.save(makeText(symbol))));
+            }
+
+            AWL_ASSERT(st.Next());
+
+            values.clear();
+
+            st.reset();
+        }
+
+        PrintSpeed(context, _T("std::any"), sw, iteration_count, _T("rows"));
+    }
+
+    {
+        awl::StopWatch sw;
+
+        for (size_t i = 0; i < iteration_count; ++i)
+        {
+            for (size_t col = 0; col < 3; ++col)
+            {
+                sqlite::bind(st, col, symbol);
+            }
+
+            AWL_ASSERT(st.Next());
+
+            st.reset();
+        }
+
+        PrintSpeed(context, _T("BumpArena"), sw, iteration_count, _T("rows"));
+    }
+}
@@ -0,0 +1,145 @@
+#include "DbContainer.h"
+#include "ExchangeModel.h"
+#include "Tests/TableHelper.h"
+
+#include "SQLiteWrapper/Set.h"
+#include "SQLiteWrapper/Scalar.h"
+#include "SQLiteWrapper/DatabaseOptions.h"
+
+#include <filesystem>
+#include <stdexcept>
+
+using namespace swtest;
+using namespace exchange::data;
+
+namespace
+{
+    const std::string fileName = "options.db";
+
+    void RemoveDatabase()
+    {
+        for (const char* suffix : { "", "-journal", "-wal", "-shm" })
+        {
+            std::filesystem::remove(fileName + suffix);
+        }
+    }
+
+    template <class T>
+    T GetPragma(Database& db, const char* name)
+    {
+        Statement stmt(db, awl::aformat() << "PRAGMA " << name << ";");
+
+        T val;
+
+        sqlite::selectScalar(stmt, val);
+
+        return val;
+    }
+
+    template <class Func>
+    bool Throws(Func&& func)
+    {
+        try
+        {
+            func();
+        }
+        catch (const SQLiteException&)
+        {
+            return true;
+        }
+
+        return false;
+    }
+}
+
+AWL_TEST(DatabaseOptionsPresets)
+{
+    RemoveDatabase();
+
+    {
+        DatabaseOptions options = DatabaseOptions::preset("low-latency-oltp");
+
+        // The page size is applied before the observers create their tables.
+        options.pageSize = 8192;
+
+        auto db = std::make_shared<Database>(fileName.c_str(), options, *context.logger);
+
+        auto set = makeSet(db, "markets", std::make_tuple(&Market::id));
+
+        set.insert(Market{ {}, "BTCUSDT", {} });
+
+        AWL_ASSERT_EQUAL(8192, GetPragma<int>(*db, "page_size"));
+        AWL_ASSERT_EQUAL(std::string("wal"), GetPragma<std::string>(*db, "journal_mode"));
+        AWL_ASSERT_EQUAL(1, GetPragma<int>(*db, "synchronous"));
+        AWL_ASSERT_EQUAL(2, GetPragma<int>(*db, "temp_store"));
+        AWL_ASSERT_EQUAL(-65536, GetPragma<int>(*db, "cache_size"));
+        AWL_ASSERT_EQUAL(1000, GetPragma<int>(*db, "wal_autocheckpoint"));
+
+        set.close();
+        db->close();
+    }
+
+    {
+        Database db(fileName.c_str(), DatabaseOptions::readOnlyAnalytics(), *context.logger);
+
+        Statement count_stmt(db, "SELECT count(*) FROM markets;");
+
+        int count;
+
+        sqlite::selectScalar(count_stmt, count);
+
+        AWL_ASSERT_EQUAL(1, count);
+        AWL_ASSERT_EQUAL(-262144, GetPragma<int>(db, "cache_size"));
+
+        AWL_ASSERT(Throws([&db]() { db.exec("DELETE FROM markets;"); }));
+    }
+
+    {
+        Database db(fileName.c_str(), DatabaseOptions::bulkLoad(), *context.logger);
+
+        AWL_ASSERT_EQUAL(std::string("memory"), GetPragma<std::string>(db, "journal_mode"));
+        AWL_ASSERT_EQUAL(std::string("exclusive"), GetPragma<std::string>(db, "locking_mode"));
+        AWL_ASSERT_EQUAL(0, GetPragma<int>(db, "synchronous"));
+    }
+
+    bool unknown = false;
+
+    try
+    {
+        DatabaseOptions::preset("fast");
+    }
+    catch (const std::invalid_argument&)
+    {
+        unknown = true;
+    }
+
+    AWL_ASSERT(unknown);
+
+    RemoveDatabase();
+}
+
+AWL_TEST(DatabaseOptionsFailure)
+{
+    RemoveDatabase();
+
+    // A read-only connection does not create the file.
+    AWL_ASSERT(Throws([&context]() { Database db(fileName.c_str(), DatabaseOptions::readOnlyAnalytics(), *context.logger); }));
+
+    AWL_ASSERT(!std::filesystem::exists(fileName));
+
+    // An in-memory database stays in MEMORY journal mode.
+    DatabaseOptions options;
+
+    options.journalMode = "WAL";
+
+    Database db(*context.logger);
+
+    AWL_ASSERT(Throws([&db, &options]() { db.open(":memory:", options); }));
+
+    // The connection is closed, so it can be opened again.
+    options.journalMode = "MEMORY";
+
+    db.open(":memory:", options);
+
+    db.exec("CREATE TABLE t (x INTEGER);");
+}
@@ -8,6 +8,15 @@ namespace swtest
 {
     using namespace sqlite;
 
+    void PrintSpeed(const awl::testing::TestContext& context, const awl::String& mode, const awl::StopWatch& sw, size_t count, const awl::String& unit)
+    {
+        const float seconds = sw.elapsedSeconds<float>();
+
+        context.logger->debug(awl::format() << mode << _T(": ") << count << _T(" ") << unit << _T(" within ") <<
+            std::fixed << std::setprecision(3) << seconds << _T(" seconds, speed: ") <<
+            std::fixed << std::setprecision(2) << count / seconds << _T(" ") << unit << _T(" per second."));
+    }
+
     //Inserts 1000 row by default.
     void DbContainer::FillDatabase(size_t batchCount, size_t transactionCount)
     {
@@ -88,12 +97,22 @@ namespace swtest
         }
     }
 
-    void DbContainer::SetAttributes(const awl::testing::TestContext & context)
+    DatabaseOptions DbContainer::MakeOptions(const awl::testing::TestContext & context)
     {
+        AWL_ATTRIBUTE(awl::String, preset, _T(""));
         AWL_ATTRIBUTE(awl::String, synchronous, _T("FULL"));
         AWL_ATTRIBUTE(awl::String, journal_mode, _T("DELETE"));
 
-        m_db->exec(awl::aformat() << "PRAGMA synchronous = " << awl::toAString(synchronous) << ";");
-        m_db->exec(awl::aformat() << "PRAGMA journal_mode = " << awl::toAString(journal_mode) << ";");
+        if (!preset.empty())
+        {
+            return DatabaseOptions::preset(awl::toAString(preset));
+        }
+
+        DatabaseOptions options;
+
+        options.synchronous = awl::toAString(synchronous);
+        options.journalMode = awl::toAString(journal_mode);
+
+        return options;
     }
 }
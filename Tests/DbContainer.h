@@ -21,19 +21,21 @@ namespace swtest
 {
     using namespace sqlite;
 
+    // Logs "<mode>: <count> <unit> within <seconds> seconds, speed: <speed> <unit> per second."
+    void PrintSpeed(const awl::testing::TestContext& context, const awl::String& mode, const awl::StopWatch& sw, size_t count, const awl::String& unit);
+
     class DbContainer
     {
     public:
 
-        DbContainer(awl::Logger& logger)
+        DbContainer(awl::Logger& logger, const DatabaseOptions& options = {})
         {
             RemoveFile();
-            m_db = std::make_shared<Database>(fileName, logger);
+            m_db = std::make_shared<Database>(fileName, options, logger);
         }
 
-        DbContainer(const awl::testing::TestContext& context) : DbContainer(*context.logger)
+        DbContainer(const awl::testing::TestContext& context) : DbContainer(*context.logger, MakeOptions(context))
         {
-            SetAttributes(context);
         }
 
         ~DbContainer()
@@ -50,7 +52,7 @@ namespace swtest
         //Inserts 1000 row by default.
         void FillDatabase(size_t batchCount = 20, size_t transactionCount = 10);
 
-        void SetAttributes(const awl::testing::TestContext & context);
+        static DatabaseOptions MakeOptions(const awl::testing::TestContext & context);
 
         std::shared_ptr<Database> m_db;
 
@@ -55,6 +55,16 @@ AWL_TEST(GetbindNull)
             AWL_ASSERT(blob.empty());
         }
 
+        {
+            std::string_view text;
+            sqlite::get(select_statement, 0, text);
+            AWL_ASSERT(text.empty());
+
+            std::span<const uint8_t> blob;
+            sqlite::get(select_statement, 1, blob);
+            AWL_ASSERT(blob.empty());
+        }
+
         AWL_ASSERT(select_statement.Next());
 
         AWL_ASSERT(select_statement.isNull(0));
@@ -111,3 +121,41 @@ AWL_TEST(GetBindOptional)
         }
     }
 }
+
+AWL_TEST(GetBindTextLifetime)
+{
+    DbContainer c(context);
+
+    c.m_db->exec(create_query);
+
+    const std::vector<std::string> sample_names = { "static", "transient", "owned" };
+
+    {
+        sqlite::Statement insert_statement(*c.m_db, insert_query);
+
+        sqlite::bind(insert_statement, 0, std::string_view(sample_names[0]));
+        insert_statement.exec();
+
+        // The temporaries are destroyed before the statement is executed.
+        sqlite::bind(insert_statement, 0, std::string_view(std::string(sample_names[1])), sqlite::Lifetime::Transient);
+        insert_statement.exec();
+
+        insert_statement.bindText(0, std::string(sample_names[2]), sqlite::Lifetime::Owned);
+        insert_statement.exec();
+    }
+
+    {
+        sqlite::Statement select_statement(*c.m_db, select_query);
+
+        for (const std::string& sample_name : sample_names)
+        {
+            AWL_ASSERT(select_statement.Next());
+
+            std::string name;
+            sqlite::get(select_statement, 0, name);
+            AWL_ASSERT(name == sample_name);
+        }
+
+        AWL_ASSERT(!select_statement.Next());
+    }
+}
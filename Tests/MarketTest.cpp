@@ -2,9 +2,15 @@
 #include "SQLiteWrapper/Bind.h"
 #include "SQLiteWrapper/Get.h"
 #include "SQLiteWrapper/Scalar.h"
+#include "SQLiteWrapper/Set.h"
+#include "SQLiteWrapper/ConnectionPool.h"
 
 #include <vector>
 #include <optional>
+#include <thread>
+#include <atomic>
+#include <exception>
+#include <filesystem>
 
 #include "Awl/IntRange.h"
 #include "Awl/StdConsole.h"
@@ -37,6 +43,8 @@ namespace
         AWL_REFLECT(dt, exchangeId, marketId, buy, sell)
     };
 
+    using MarketPriceSet = Set<MarketPricePair, TimePoint>;
+
     PricePair MakePricePair(size_t i)
     {
         return PricePair{ Clock::now(), static_cast<double>(i), static_cast<double>(i) * 0.99 };
@@ -75,9 +83,9 @@ namespace
     }
 
     template <class Price = PricePair>
-    Statement MakeInsertStatement(Database & db, std::optional<size_t> i = {})
+    Statement MakeInsertStatement(Database & db, std::optional<size_t> i = {}, unsigned int prepare_flags = 0u)
     {
-        return Statement(db, buildParameterizedInsertQuery<Price>(MakeTableName(i)));
+        return Statement(db, buildParameterizedInsertQuery<Price>(MakeTableName(i)), prepare_flags);
     }
 
     size_t GetCount(Database & db, std::optional<size_t> i = {})
@@ -257,6 +265,108 @@ AWL_TEST(InsertMarketPrice)
     CheckCount(db, batch_size * batch_count);
 }
 
+//--output all --filter InsertMarketPriceBatch_Test --batch_count 100 --batch_size 100000 --commit_count 10000
+AWL_TEST(InsertMarketPriceBatch)
+{
+    AWL_ATTRIBUTE(size_t, batch_count, 10);
+    AWL_ATTRIBUTE(size_t, batch_size, 10);
+    AWL_ATTRIBUTE(size_t, commit_count, MarketPriceSet::defaultCommitCount);
+
+    DbContainer c(context);
+    Database & db = c.db();
+
+    CreateTable<MarketPricePair>(db);
+
+    MarketPriceSet set(c.m_db, tableName, std::make_tuple(&MarketPricePair::dt));
+
+    std::vector<MarketPricePair> v;
+    v.reserve(batch_size);
+
+    for (size_t batch_index = 0; batch_index < batch_count; ++batch_index)
+    {
+        v.clear();
+
+        for (size_t local_index = 0; local_index < batch_size; ++local_index)
+        {
+            MarketPricePair price = MakeMarketPricePair(batch_index * batch_size + local_index);
+
+            // Clock::now() is not guaranteed to be unique.
+            price.dt = TimePoint(std::chrono::nanoseconds(batch_index * batch_size + local_index));
+
+            v.push_back(price);
+        }
+
+        awl::StopWatch sw;
+
+        set.insertBatch(v, commit_count);
+
+        PrintStat(context, sw, batch_index, batch_size);
+    }
+
+    CheckCount(db, batch_size * batch_count);
+}
+
+//--output all --filter ScanMarketPrice_Test --row_count 1000000
+AWL_TEST(ScanMarketPrice)
+{
+    AWL_ATTRIBUTE(size_t, row_count, 1000);
+
+    DbContainer c(context);
+    Database & db = c.db();
+
+    CreateTable<MarketPricePair>(db);
+
+    MarketPriceSet set(c.m_db, tableName, std::make_tuple(&MarketPricePair::dt));
+
+    {
+        std::vector<MarketPricePair> v;
+        v.reserve(row_count);
+
+        for (size_t i = 0; i < row_count; ++i)
+        {
+            MarketPricePair price = MakeMarketPricePair(i);
+
+            price.dt = TimePoint(Clock::duration(i + 1));
+
+            v.push_back(price);
+        }
+
+        set.insertBatch(v);
+    }
+
+    auto scan = [&context, row_count](const awl::String& mode, auto&& range)
+    {
+        awl::StopWatch sw;
+
+        size_t count = 0;
+
+        double sum = 0;
+
+        for (const MarketPricePair& price : range)
+        {
+            sum += price.buy;
+
+            ++count;
+        }
+
+        const float seconds = sw.elapsedSeconds<float>();
+
+        context.logger->debug(awl::format() << mode << _T(": ") << count << _T(" rows have been read within ") <<
+            std::fixed << std::setprecision(3) << seconds << _T(" seconds, speed: ") <<
+            std::fixed << std::setprecision(2) << count / seconds << _T(" rows per second."));
+
+        AWL_ASSERT_EQUAL(row_count, count);
+
+        return sum;
+    };
+
+    const double sum = scan(_T("Iterator"), set);
+
+    const double reusing_sum = scan(_T("ReusingIterator"), set.reusingRange());
+
+    AWL_ASSERT(sum == reusing_sum);
+}
+
 AWL_TEST(Mars)
 {
     AWL_ATTRIBUTE(size_t, batch_count, 10);
@@ -305,61 +415,233 @@ AWL_TEST(Mars)
     CheckCount(db, batch_size * batch_count);
 }
 
-//--output all --filter MarsMt_Test --batch_count 1000000 --batch_size 1000 --transaction --synchronous OFF  --journal_mode TRUNCATE
+//--output all --filter MarsMt_Test --batch_count 100 --batch_size 10000 --thread_count 8 --lookup_count 1000000
 AWL_TEST(MarsMt)
 {
     AWL_ATTRIBUTE(size_t, batch_count, 10);
     AWL_ATTRIBUTE(size_t, batch_size, 10);
+    AWL_ATTRIBUTE(size_t, thread_count, 4);
+    AWL_ATTRIBUTE(size_t, lookup_count, 1000);
 
-    DbContainer c(context);
-    Database & db = c.db();
+    const std::string file_name = "mt.db";
 
+    auto remove_files = [&file_name]()
     {
-        //Create the tables first to prevent "database schema has changed" error.
-        for (size_t i : awl::make_count(batch_size))
+        for (const char* suffix : { "", "-wal", "-shm" })
         {
-            CreateTable(db, i);
+            std::filesystem::remove(file_name + suffix);
         }
+    };
 
-        std::vector<Statement> v;
+    remove_files();
+
+    auto make_batch = [batch_size](size_t batch_index)
+    {
+        std::vector<MarketPricePair> v;
         v.reserve(batch_size);
 
-        for (size_t i : awl::make_count(batch_size))
+        for (size_t local_index = 0; local_index < batch_size; ++local_index)
         {
-            v.push_back(MakeInsertStatement(db, i));
+            const size_t i = batch_index * batch_size + local_index;
+
+            MarketPricePair val = MakeMarketPricePair(i);
+
+            // The keys should be unique.
+            val.dt = TimePoint(Clock::duration(i + 1));
+
+            v.push_back(val);
         }
 
-        for (size_t batch_index : awl::make_count(batch_count))
+        return v;
+    };
+
+    {
+        ConnectionPool pool(file_name, thread_count, *context.logger);
+
         {
-            awl::StopWatch sw;
+            ConnectionLease writer = pool.acquireWriter();
 
-            for (size_t local_index = 0; local_index < batch_size; ++local_index)
+            CreateTable<MarketPricePair>(*writer);
+
+            MarketPriceSet set(writer.database(), tableName, std::make_tuple(&MarketPricePair::dt));
+
+            set.insertBatch(make_batch(0));
+        }
+
+        std::vector<std::exception_ptr> errors(thread_count + 1);
+
+        std::atomic<size_t> found_count = 0;
+
+        awl::StopWatch sw;
+
+        std::vector<std::thread> threads;
+        threads.reserve(thread_count + 1);
+
+        // The writer appends the batches while the readers look up the rows of the first batch.
+        threads.emplace_back([&pool, &errors, &make_batch, batch_count]()
+        {
+            try
             {
-                Statement & s = v[local_index];
+                for (size_t batch_index = 1; batch_index < batch_count; ++batch_index)
+                {
+                    ConnectionLease writer = pool.acquireWriter();
 
-                const size_t i = batch_index * batch_size + local_index;
+                    MarketPriceSet set(writer.database(), tableName, std::make_tuple(&MarketPricePair::dt));
+
+                    set.insertBatch(make_batch(batch_index));
+                }
+            }
+            catch (...)
+            {
+                errors[0] = std::current_exception();
+            }
+        });
 
+        for (size_t thread_index = 0; thread_index < thread_count; ++thread_index)
+        {
+            threads.emplace_back([&pool, &errors, &found_count, thread_index, batch_size, lookup_count]()
+            {
                 try
                 {
-                    sqlite::bind(s, 0, MakePricePair(i));
-                    s.select();
-                    s.reset();
+                    ConnectionLease reader = pool.acquireReader();
+
+                    MarketPriceSet set(reader.database(), tableName, std::make_tuple(&MarketPricePair::dt));
+
+                    size_t local_count = 0;
+
+                    for (size_t lookup_index = 0; lookup_index < lookup_count; ++lookup_index)
+                    {
+                        const size_t i = (thread_index + lookup_index * 7919) % batch_size;
+
+                        MarketPricePair val;
+
+                        if (set.find(std::make_tuple(TimePoint(Clock::duration(i + 1))), val))
+                        {
+                            ++local_count;
+                        }
+                    }
+
+                    found_count += local_count;
                 }
-                catch (const SQLiteException & e)
+                catch (...)
                 {
-                    context.logger->debug(e.message());
-                    AWL_FAIL;
+                    errors[thread_index + 1] = std::current_exception();
                 }
-            }
+            });
+        }
 
-            PrintStat(context, sw, batch_index, batch_size);
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+
+        const float seconds = sw.elapsedSeconds<float>();
+
+        for (const std::exception_ptr& error : errors)
+        {
+            if (error)
+            {
+                std::rethrow_exception(error);
+            }
         }
+
+        const size_t total_lookup_count = thread_count * lookup_count;
+
+        context.logger->debug(awl::format() << total_lookup_count << _T(" lookups in ") << thread_count << _T(" threads and ") <<
+            (batch_count - 1) * batch_size << _T(" inserts have been done within ") <<
+            std::fixed << std::setprecision(2) << seconds <<
+            _T(" seconds, speed: ") <<
+            std::fixed << std::setprecision(2) << total_lookup_count / seconds <<
+            _T(" lookups per second."));
+
+        // The rows of the first batch are inserted before the readers start.
+        AWL_ASSERT_EQUAL(total_lookup_count, found_count.load());
+
+        ConnectionLease writer = pool.acquireWriter();
+
+        CheckCount(*writer, batch_count * batch_size);
     }
 
-    for (size_t local_index = 0; local_index < batch_size; ++local_index)
+    remove_files();
+}
+
+// The connection is closed when the last statement is finalized.
+AWL_TEST(CloseWithLiveStatement)
+{
+    Database db(":memory:", *context.logger);
+
+    db.exec("CREATE TABLE t (x INTEGER); INSERT INTO t VALUES (1), (2);");
+
+    Statement s(db, "SELECT x FROM t;");
+
+    AWL_ASSERT(s.Next());
+
+    db.close();
+
+    // The statement still works after the database is closed.
+    AWL_ASSERT(s.Next());
+    AWL_ASSERT(!s.Next());
+}
+
+//--output all --filter PreparePersistent_Test --batch_count 100 --batch_size 1000 --statement_count 1000
+AWL_TEST(PreparePersistent)
+{
+    AWL_ATTRIBUTE(size_t, batch_count, 10);
+    AWL_ATTRIBUTE(size_t, batch_size, 10);
+    AWL_ATTRIBUTE(size_t, statement_count, 10);
+
+    // The rows are inserted with the statements in turn.
+    AWL_ASSERT(statement_count != 0u);
+
+    DbContainer c(context);
+    Database & db = c.db();
+
+    CreateTable<MarketPricePair>(db);
+
+    size_t row_index = 0;
+
+    // Compare long-lived statements prepared with and without SQLITE_PREPARE_PERSISTENT.
+    for (const unsigned int prepare_flags : { 0u, static_cast<unsigned int>(SQLITE_PREPARE_PERSISTENT) })
     {
-        CheckCount(db, batch_count, local_index);
+        const awl::String mode = prepare_flags == 0u ? _T("default") : _T("persistent");
+
+        std::vector<Statement> v;
+        v.reserve(statement_count);
+
+        {
+            awl::StopWatch sw;
+
+            for (size_t i : awl::make_count(statement_count))
+            {
+                static_cast<void>(i);
+
+                v.push_back(MakeInsertStatement<MarketPricePair>(db, {}, prepare_flags));
+            }
+
+            context.logger->debug(awl::format() << mode << _T(": ") << statement_count << _T(" statements have been prepared within ") <<
+                std::fixed << std::setprecision(6) << sw.elapsedSeconds<float>() << _T(" seconds."));
+        }
+
+        for (size_t batch_index : awl::make_count(batch_count))
+        {
+            awl::StopWatch sw;
+
+            db.tryRun([&v, &row_index, batch_size]()
+            {
+                for (size_t local_index = 0; local_index < batch_size; ++local_index)
+                {
+                    Statement & s = v[local_index % v.size()];
+
+                    sqlite::bind(s, 0, MakeMarketPricePair(row_index++));
+                    s.exec();
+                }
+            });
+
+            PrintStat(context, sw, batch_index, batch_size);
+        }
     }
+
+    CheckCount(db, row_index);
 }
 
 namespace
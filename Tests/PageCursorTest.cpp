@@ -0,0 +1,119 @@
+#include "DbContainer.h"
+#include "ExchangeModel.h"
+#include "Tests/TableHelper.h"
+
+#include "SQLiteWrapper/Set.h"
+#include "SQLiteWrapper/PageCursor.h"
+
+#include <vector>
+#include <string>
+#include <algorithm>
+
+using namespace swtest;
+using namespace exchange::data;
+
+namespace
+{
+    struct Price
+    {
+        std::string marketId;
+        TimePoint dt;
+        double value;
+
+        AWL_REFLECT(marketId, dt, value)
+    };
+
+    AWL_MEMBERWISE_EQUATABLE(Price)
+}
+
+AWL_TEST(PageCursor)
+{
+    AWL_ATTRIBUTE(size_t, page_size, 5);
+
+    DbContainer c(context);
+
+    auto storage = makeSet(c.m_db, "prices", std::make_tuple(&Price::marketId, &Price::dt));
+
+    std::vector<Price> prices;
+
+    // The rows are inserted in the reverse key order and the page size does not divide the row count.
+    for (const char* market_id : { "TRXUSDT", "ETHUSDT", "BTCUSDT" })
+    {
+        for (size_t i = 8; i != 0; --i)
+        {
+            Price price{ market_id, TimePoint(std::chrono::seconds(i)), static_cast<double>(prices.size()) };
+
+            storage.insert(price);
+
+            prices.push_back(price);
+        }
+    }
+
+    std::ranges::sort(prices, [](const Price& a, const Price& b)
+    {
+        return std::tie(a.marketId, a.dt) < std::tie(b.marketId, b.dt);
+    });
+
+    std::vector<Price> result;
+
+    sqlite::PageCursor<Price, std::string, TimePoint>::State saved_state;
+
+    std::string encoded_state;
+
+    {
+        sqlite::PageCursor cursor(storage, page_size);
+
+        std::vector<Price> page;
+
+        // Read two pages and save the state.
+        for (size_t i = 0; i < 2; ++i)
+        {
+            AWL_ASSERT(cursor.next(page));
+
+            AWL_ASSERT_EQUAL(page_size, page.size());
+
+            result.insert(result.end(), page.begin(), page.end());
+        }
+
+        saved_state = cursor.state();
+
+        encoded_state = cursor.saveState();
+    }
+
+    {
+        // The state is restored from its text.
+        sqlite::PageCursor cursor(storage, page_size);
+
+        AWL_ASSERT(cursor.saveState().empty());
+
+        cursor.restoreState(encoded_state);
+
+        AWL_ASSERT(cursor.state() == saved_state);
+
+        AWL_ASSERT_EQUAL(encoded_state, cursor.saveState());
+
+        cursor.restoreState({});
+
+        AWL_ASSERT(!cursor.state());
+    }
+
+    {
+        // Continue with a new cursor and another page size.
+        sqlite::PageCursor cursor(storage, page_size + 1, saved_state);
+
+        std::vector<Price> page;
+
+        while (cursor.next(page))
+        {
+            AWL_ASSERT(page.size() <= page_size + 1);
+
+            result.insert(result.end(), page.begin(), page.end());
+        }
+
+        AWL_ASSERT(page.empty());
+
+        AWL_ASSERT(!cursor.next(page));
+    }
+
+    AWL_ASSERT(result == prices);
+}
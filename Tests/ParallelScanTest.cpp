@@ -0,0 +1,140 @@
+#include "DbContainer.h"
+
+#include "SQLiteWrapper/Set.h"
+#include "SQLiteWrapper/TableBuilder.h"
+#include "SQLiteWrapper/ConnectionPool.h"
+#include "SQLiteWrapper/ParallelScan.h"
+
+#include "Awl/StopWatch.h"
+
+#include <vector>
+#include <string>
+#include <filesystem>
+
+using namespace swtest;
+
+namespace
+{
+    struct Trade
+    {
+        int64_t id;
+        std::string marketId;
+        double amount;
+
+        AWL_REFLECT(id, marketId, amount)
+    };
+
+    void RemoveFiles(const std::string& file_name)
+    {
+        for (const char* suffix : { "", "-wal", "-shm" })
+        {
+            std::filesystem::remove(file_name + suffix);
+        }
+    }
+}
+
+//--output all --filter ParallelScan_Test --row_count 1000000 --thread_count 8
+AWL_TEST(ParallelScan)
+{
+    AWL_ATTRIBUTE(size_t, row_count, 1000);
+    AWL_ATTRIBUTE(size_t, thread_count, 4);
+
+    const std::string file_name = "scan.db";
+
+    const std::string table_name = "trades";
+
+    RemoveFiles(file_name);
+
+    {
+        sqlite::ConnectionPool pool(file_name, thread_count, *context.logger);
+
+        struct Result
+        {
+            size_t count = 0;
+
+            double amount = 0;
+        };
+
+        auto scan = [&](size_t scan_thread_count)
+        {
+            std::vector<Result> results(scan_thread_count);
+
+            awl::StopWatch sw;
+
+            sqlite::parallelScan<Trade>(pool, table_name, scan_thread_count, [&results](size_t shard_index, const Trade& trade)
+            {
+                Result& result = results[shard_index];
+
+                ++result.count;
+
+                result.amount += trade.amount;
+            });
+
+            Result total;
+
+            for (const Result& result : results)
+            {
+                total.count += result.count;
+                total.amount += result.amount;
+            }
+
+            context.logger->debug(awl::format() << scan_thread_count << _T(" threads: ") << total.count << _T(" rows have been read within ") <<
+                std::fixed << std::setprecision(3) << sw.elapsedSeconds<float>() << _T(" seconds."));
+
+            return total;
+        };
+
+        {
+            sqlite::ConnectionLease writer = pool.acquireWriter();
+
+            sqlite::TableBuilder<Trade> builder(table_name);
+
+            builder.setColumnConstraint(&Trade::id, "INTEGER NOT NULL PRIMARY KEY");
+
+            writer->exec(builder.create());
+        }
+
+        // An empty table.
+        AWL_ASSERT_EQUAL(0u, scan(thread_count).count);
+
+        double expected_amount = 0;
+
+        {
+            sqlite::ConnectionLease writer = pool.acquireWriter();
+
+            sqlite::Set<Trade, int64_t> set(writer.database(), table_name, std::make_tuple(&Trade::id));
+
+            std::vector<Trade> trades;
+
+            // The rowids are sparse and negative.
+            for (size_t i = 0; i < row_count; ++i)
+            {
+                const Trade trade{ static_cast<int64_t>(i * 3) - 100, "m" + std::to_string(i % 10), static_cast<double>(i % 100) };
+
+                expected_amount += trade.amount;
+
+                trades.push_back(trade);
+            }
+
+            set.insertBatch(trades);
+        }
+
+        for (size_t scan_thread_count : { size_t(1), thread_count, thread_count * 2 })
+        {
+            const Result total = scan(scan_thread_count);
+
+            AWL_ASSERT_EQUAL(row_count, total.count);
+
+            AWL_ASSERT(total.amount == expected_amount);
+        }
+
+        // The reader leased by the caller is not waited for.
+        {
+            sqlite::ConnectionLease reader = pool.acquireReader();
+
+            AWL_ASSERT_EQUAL(row_count, scan(thread_count).count);
+        }
+    }
+
+    RemoveFiles(file_name);
+}
@@ -22,6 +22,104 @@ AWL_TEST(FieldIndex)
     AWL_ASSERT(sqlite::helpers::findFieldIndex(&Market::id) == 1);
 
     AWL_ASSERT(sqlite::helpers::findTransparentFieldIndex(&Market::id) == 6);
+
+    AWL_ASSERT(sqlite::helpers::findTransparentFieldIndex(&Market::precision, &Precision::base) == 7);
+
+    AWL_ASSERT(sqlite::helpers::findTransparentFieldIndex(&Market::limits, &Limits::price, &Range::max) == 3);
+}
+
+AWL_TEST(NestedFieldPath)
+{
+    DbContainer c(context);
+
+    {
+        sqlite::TableBuilder<Market> builder("nested_markets");
+
+        builder.setPrimaryKey(&Market::id, std::make_tuple(&Market::precision, &Precision::base));
+
+        const std::string query = builder.create();
+
+        AWL_ASSERT(query.find("PRIMARY KEY(id ,precision_base)") != std::string::npos);
+
+        c.db().exec(query);
+    }
+
+    auto ms = makeSet(c.m_db, "markets", std::make_tuple(&Market::id));
+
+    const Market m_sample{ {}, "abc", { 1, 2, 3, 4 } };
+
+    ms.insert(m_sample);
+
+    // Builds UPDATE markets SET limits_price_max=?4, precision_base=?8 WHERE id=?7;
+    sqlite::Updater up = ms.createUpdater(std::make_tuple(
+        std::make_tuple(&Market::limits, &Limits::price, &Range::max),
+        std::make_tuple(&Market::precision, &Precision::base)));
+
+    Market m_updated = m_sample;
+
+    m_updated.limits.price.max = 100;
+    m_updated.precision.base = 5;
+
+    // Not updated.
+    Market m_changed = m_updated;
+
+    m_changed.precision.quote = 6;
+
+    up.update(m_changed);
+
+    Market m_found;
+
+    AWL_ASSERT(ms.find(m_sample.id, m_found));
+
+    AWL_ASSERT(m_found == m_updated);
+}
+
+AWL_TEST(IndexFilter)
+{
+    AWL_UNUSED_CONTEXT;
+
+    sqlite::IndexFilter filter{ 5, 1, 3 };
+
+    // The elements stay in the order they were added in.
+    AWL_ASSERT(std::ranges::equal(filter, std::vector<size_t>{ 5, 1, 3 }));
+
+    AWL_ASSERT(filter.contains(1) && filter.contains(3) && filter.contains(5));
+    AWL_ASSERT(!filter.contains(0) && !filter.contains(2) && !filter.contains(100));
+
+    AWL_ASSERT_EQUAL(0u, filter.index_of(5));
+    AWL_ASSERT_EQUAL(2u, filter.index_of(3));
+
+    AWL_ASSERT(filter.erase(1));
+    AWL_ASSERT(!filter.erase(1));
+
+    AWL_ASSERT(!filter.contains(1));
+    AWL_ASSERT_EQUAL(1u, filter.index_of(3));
+
+    filter.insert(1);
+
+    AWL_ASSERT_EQUAL(2u, filter.index_of(1));
+    AWL_ASSERT_EQUAL(3u, filter.size());
+
+    auto throws = [&filter](size_t val)
+    {
+        try
+        {
+            filter.insert(val);
+        }
+        catch (const std::exception&)
+        {
+            return true;
+        }
+
+        return false;
+    };
+
+    // A duplicate, a field that was not found and an index that can't be a column.
+    AWL_ASSERT(throws(3));
+    AWL_ASSERT(throws(sqlite::noIndex));
+    AWL_ASSERT(throws(1000000));
+
+    AWL_ASSERT_EQUAL(3u, filter.size());
 }
 
 AWL_TEST(SetStorageMarket)
@@ -336,6 +434,176 @@ AWL_TEST(SetStorageMax)
     CheckMax(c.db(), trx_market_id, 1);
 }
 
+AWL_TEST(SetUpsert)
+{
+    DbContainer c(context);
+
+    auto storage = makeSet(c.m_db, "orders", std::make_tuple(&Order::marketId, &Order::id));
+
+    storage.insert(trx_order1);
+
+    const sqlite::RowId last_row_id = c.m_db->lastRowId();
+
+    AWL_ASSERT(storage.upsert(btc_order1));
+
+    Order btc_order1_updated = btc_order1;
+
+    btc_order1_updated.filled = "0.0015"_d;
+    btc_order1_updated.updateTime = Clock::now();
+
+    const sqlite::RowId inserted_row_id = c.m_db->lastRowId();
+
+    AWL_ASSERT(inserted_row_id != last_row_id);
+
+    AWL_ASSERT(!storage.upsert(btc_order1_updated));
+
+    // The update does not change the last insert rowid.
+    AWL_ASSERT_EQUAL(inserted_row_id, c.m_db->lastRowId());
+
+    {
+        Order order;
+
+        AWL_ASSERT(storage.find(btc_key1, order));
+        AWL_ASSERT(order == btc_order1_updated);
+    }
+
+    AWL_ASSERT(!storage.insertOrIgnore(btc_order1));
+
+    AWL_ASSERT(storage.insertOrIgnore(btc_order2));
+
+    {
+        Order order;
+
+        AWL_ASSERT(storage.find(btc_key1, order));
+        AWL_ASSERT(order == btc_order1_updated);
+
+        AWL_ASSERT(storage.find(btc_key2, order));
+        AWL_ASSERT(order == btc_order2);
+    }
+
+    storage.insertOrReplace(btc_order1);
+
+    {
+        Order order;
+
+        AWL_ASSERT(storage.find(btc_key1, order));
+        AWL_ASSERT(order == btc_order1);
+    }
+
+    size_t count = 0;
+
+    for ([[maybe_unused]] const Order& order : storage)
+    {
+        ++count;
+    }
+
+    AWL_ASSERT_EQUAL(3u, count);
+}
+
+namespace
+{
+    struct OrderState
+    {
+        OrderStatus status;
+        Decimal price;
+
+        AWL_REFLECT(status, price)
+    };
+}
+
+AWL_TEST(SetProjection)
+{
+    DbContainer c(context);
+
+    auto storage = makeSet(c.m_db, "orders", std::make_tuple(&Order::marketId, &Order::id));
+
+    storage.insert(btc_order1);
+    storage.insert(btc_order2);
+    storage.insert(trx_order1);
+
+    // The columns are in the order of the pointers, but not in the order of the structure.
+    auto projector = storage.select<OrderState>(std::make_tuple(&Order::status, &Order::price));
+
+    {
+        OrderState state;
+
+        AWL_ASSERT(projector.find(btc_key2, state));
+        AWL_ASSERT(state.status == btc_order2.status);
+        AWL_ASSERT(state.price == btc_order2.price);
+
+        AWL_ASSERT(!projector.find(std::make_tuple(std::string("XYZUSDT"), OrderId(1)), state));
+    }
+
+    {
+        size_t count = 0;
+
+        for (const OrderState& state : projector)
+        {
+            AWL_ASSERT(state.price == btc_order1.price || state.price == btc_order2.price || state.price == trx_order1.price);
+
+            ++count;
+        }
+
+        AWL_ASSERT_EQUAL(3u, count);
+    }
+
+    {
+        auto id_projector = storage.select<std::tuple<OrderId, std::string>>(std::make_tuple(&Order::id, &Order::marketId));
+
+        std::tuple<OrderId, std::string> ids;
+
+        AWL_ASSERT(id_projector.find(trx_key1, ids));
+        AWL_ASSERT(ids == std::make_tuple(trx_order1.id, trx_order1.marketId));
+    }
+
+    // The key columns are read from the primary key index without the table.
+    {
+        const std::string query = "EXPLAIN QUERY PLAN " + sqlite::buildParameterizedProjectionQuery<Order>("orders",
+            sqlite::helpers::findTransparentFieldIndices(std::make_tuple(&Order::id)));
+
+        sqlite::Statement plan(c.db(), query);
+
+        bool covering = false;
+
+        while (plan.Next())
+        {
+            std::string detail;
+
+            sqlite::get(plan, 3, detail);
+
+            covering = covering || detail.find("COVERING INDEX") != std::string::npos;
+        }
+
+        AWL_ASSERT(covering);
+    }
+}
+
+AWL_TEST(SetReusingRange)
+{
+    DbContainer c(context);
+
+    auto storage = makeSet(c.m_db, "orders", std::make_tuple(&Order::marketId, &Order::id));
+
+    storage.insert(btc_order1);
+    storage.insert(btc_order2);
+    storage.insert(trx_order1);
+
+    std::vector<Order> orders;
+
+    for (const Order& order : storage)
+    {
+        orders.push_back(order);
+    }
+
+    AWL_ASSERT_EQUAL(3u, orders.size());
+
+    // The same value is overwritten with each row.
+    AWL_ASSERT(std::ranges::equal(storage.reusingRange(), orders));
+
+    // The statement is reset, so it can be iterated over again.
+    AWL_ASSERT(std::ranges::equal(storage.reusingRange(), orders));
+}
+
 AWL_TEST(OrderStorageGetBind2)
 {
     DbContainer c(context);
@@ -740,3 +1008,368 @@ AWL_TEST(OrderStorageGetBind5)
 
     AWL_ASSERT(std::ranges::equal(storage, sample_v));
 }
+
+AWL_TEST(SetInsertBatch)
+{
+    AWL_ATTRIBUTE(size_t, order_count, 1000);
+    AWL_ATTRIBUTE(size_t, commit_count, 300);
+
+    DbContainer c(context);
+
+    auto storage = makeSet(c.m_db, "orders", std::make_tuple(&v5::Order::marketId, &v5::Order::id));
+
+    std::vector<v5::Order> orders;
+    orders.reserve(order_count);
+
+    for (size_t i = 0; i < order_count; ++i)
+    {
+        v5::Order order = makeSampleOrder5();
+
+        order.id = static_cast<OrderId>(i);
+        order.clientGuid = std::to_string(i);
+
+        orders.push_back(std::move(order));
+    }
+
+    // An odd chunk size is inserted with the statements for the powers of two.
+    storage.insertBatch(std::span<const v5::Order>(orders.data(), orders.size() - 1), commit_count);
+
+    storage.insertRange(orders.end() - 1, orders.end());
+
+    AWL_ASSERT(std::ranges::equal(storage, orders));
+
+    // A duplicate key rolls back the current chunk.
+    try
+    {
+        storage.insertBatch(orders, commit_count);
+
+        AWL_FAILM("It does not throw.");
+    }
+    catch (const sqlite::SQLiteException& e)
+    {
+        context.logger->debug(e.message());
+    }
+
+    AWL_ASSERT_EQUAL(order_count, static_cast<size_t>(std::ranges::distance(storage)));
+}
+
+// The shared queries are bounded, so a set keeps its own queries when the other sets evict them.
+AWL_TEST(SetSharedQueries)
+{
+    AWL_ATTRIBUTE(size_t, table_count, 300);
+
+    DbContainer c(context);
+
+    auto ms = makeSet(c.m_db, "dynamic_markets", std::make_tuple(&Market::id));
+
+    for (size_t i = 0; i < table_count; ++i)
+    {
+        makeSet(c.m_db, "dynamic_markets_" + std::to_string(i), std::make_tuple(&Market::id));
+    }
+
+    const Market m_sample{ {}, "abc", { 1, 2, 3, 4 } };
+
+    // The upsert statement is prepared on the first use.
+    AWL_ASSERT(ms.upsert(m_sample));
+
+    Market m_found;
+
+    AWL_ASSERT(ms.find(m_sample.id, m_found));
+
+    AWL_ASSERT(m_found == m_sample);
+}
+
+//--output all --filter SetConstructionBenchmark_Test --set_count 100000
+AWL_TEST(SetConstructionBenchmark)
+{
+    AWL_ATTRIBUTE(size_t, set_count, 100);
+
+    DbContainer c(context);
+
+    const std::string table_name = "orders";
+
+    makeSet(c.m_db, table_name, std::make_tuple(&v5::Order::marketId, &v5::Order::id));
+
+    // What the Set constructor did before the queries were built once per table.
+    {
+        const sqlite::IndexFilter id_indices = sqlite::helpers::findTransparentFieldIndices(std::make_tuple(&v5::Order::marketId, &v5::Order::id));
+
+        size_t length = 0;
+
+        awl::StopWatch sw;
+
+        for (size_t i = 0; i < set_count; ++i)
+        {
+            length += sqlite::buildParameterizedInsertQuery<v5::Order>(table_name).size();
+            length += sqlite::buildParameterizedSelectQuery<v5::Order>(table_name, {}, id_indices).size();
+            length += sqlite::buildParameterizedDeleteQuery<v5::Order>(table_name, id_indices).size();
+            length += sqlite::buildTrivialSelectQuery<v5::Order>(table_name).size();
+        }
+
+        PrintSpeed(context, _T("Building the queries"), sw, set_count, _T("iterations"));
+
+        AWL_ASSERT(length != 0);
+    }
+
+    {
+        awl::StopWatch sw;
+
+        for (size_t i = 0; i < set_count; ++i)
+        {
+            sqlite::Set<v5::Order, std::string, OrderId> set(c.m_db, table_name, std::make_tuple(&v5::Order::marketId, &v5::Order::id));
+        }
+
+        PrintSpeed(context, _T("Constructing the set"), sw, set_count, _T("iterations"));
+    }
+}
+
+//--output all --filter SetOrderBenchmark_Test --order_count 100000
+AWL_TEST(SetOrderBenchmark)
+{
+    AWL_ATTRIBUTE(size_t, order_count, 100);
+
+    DbContainer c(context);
+
+    auto storage = makeSet(c.m_db, "orders", std::make_tuple(&v5::Order::marketId, &v5::Order::id));
+
+    std::vector<v5::Order> orders;
+    orders.reserve(order_count);
+
+    for (size_t i = 0; i < order_count; ++i)
+    {
+        v5::Order order = makeSampleOrder5();
+
+        order.id = static_cast<OrderId>(i);
+
+        orders.push_back(std::move(order));
+    }
+
+    storage.insertBatch(orders);
+
+    // The operations run in a transaction to measure the binding, but not fsync.
+    c.db().tryRun([&]()
+    {
+        {
+            awl::StopWatch sw;
+
+            for (v5::Order& order : orders)
+            {
+                AWL_ASSERT(storage.find(order));
+            }
+
+            PrintSpeed(context, _T("find"), sw, order_count, _T("operations"));
+        }
+
+        {
+            auto updater = storage.createUpdater(std::make_tuple(&v5::Order::price, &v5::Order::amount));
+
+            awl::StopWatch sw;
+
+            for (v5::Order& order : orders)
+            {
+                order.price = "45442.5"_d;
+
+                updater.update(order);
+            }
+
+            PrintSpeed(context, _T("update"), sw, order_count, _T("operations"));
+        }
+
+        {
+            awl::StopWatch sw;
+
+            for (const v5::Order& order : orders)
+            {
+                storage.deleteElement(order);
+            }
+
+            PrintSpeed(context, _T("delete"), sw, order_count, _T("operations"));
+        }
+    });
+
+    AWL_ASSERT_EQUAL(0u, static_cast<size_t>(std::ranges::distance(storage)));
+}
+
+namespace
+{
+    struct Candle
+    {
+        int64_t exchangeId;
+        std::string marketId;
+        TimePoint dt;
+        double price;
+
+        AWL_REFLECT(exchangeId, marketId, dt, price)
+    };
+
+    AWL_MEMBERWISE_EQUATABLE(Candle)
+}
+
+AWL_TEST(SetRange)
+{
+    DbContainer c(context);
+
+    auto storage = makeSet(c.m_db, "candles", std::make_tuple(&Candle::exchangeId, &Candle::marketId, &Candle::dt));
+
+    const std::vector<std::string> market_ids = { "BTCUSDT", "ETHUSDT", "TRXUSDT" };
+
+    const size_t time_count = 5;
+
+    auto make_time = [](size_t i)
+    {
+        return TimePoint(std::chrono::seconds(i + 1));
+    };
+
+    std::vector<Candle> candles;
+
+    // In the key order.
+    for (int64_t exchange_id = 1; exchange_id <= 2; ++exchange_id)
+    {
+        for (const std::string& market_id : market_ids)
+        {
+            for (size_t i = 0; i < time_count; ++i)
+            {
+                candles.push_back(Candle{ exchange_id, market_id, make_time(i), static_cast<double>(candles.size()) });
+            }
+        }
+    }
+
+    // Insert in the reverse order.
+    for (auto i = candles.rbegin(); i != candles.rend(); ++i)
+    {
+        storage.insert(*i);
+    }
+
+    const auto market_first = candles.begin() + time_count;
+    const auto market_last = market_first + time_count;
+
+    AWL_ASSERT(std::ranges::equal(storage.equalRange(std::make_tuple(int64_t(1), std::string("ETHUSDT"))),
+        std::ranges::subrange(market_first, market_last)));
+
+    AWL_ASSERT(std::ranges::equal(storage.equalRange(std::make_tuple(int64_t(2))),
+        std::ranges::subrange(candles.begin() + market_ids.size() * time_count, candles.end())));
+
+    // The prefix is converted to the key types.
+    AWL_ASSERT(std::ranges::equal(storage.lowerBound(std::make_tuple(1, "ETHUSDT", make_time(2))),
+        std::ranges::subrange(market_first + 2, candles.end())));
+
+    AWL_ASSERT(std::ranges::equal(storage.upperBound(std::make_tuple(int64_t(1), std::string("ETHUSDT"))),
+        std::ranges::subrange(market_last, candles.end())));
+
+    {
+        auto range = storage.upperBound(std::make_tuple(int64_t(2)));
+
+        AWL_ASSERT(range.begin() == range.end());
+    }
+
+    // The statement is reset when the range is destroyed, so it can be reused with another prefix.
+    for (size_t i = 0; i < 2; ++i)
+    {
+        auto range = storage.equalRange(std::make_tuple(int64_t(1), market_ids[i]));
+
+        AWL_ASSERT_EQUAL(time_count, static_cast<size_t>(std::ranges::distance(range)));
+    }
+}
+
+AWL_TEST(SetFindMany)
+{
+    DbContainer c(context);
+
+    auto storage = makeSet(c.m_db, "orders", std::make_tuple(&v5::Order::marketId, &v5::Order::id));
+
+    std::vector<v5::Order> orders;
+
+    for (size_t i = 0; i < 10; ++i)
+    {
+        v5::Order order = makeSampleOrder5();
+
+        order.id = static_cast<OrderId>(i);
+
+        storage.insert(order);
+
+        orders.push_back(std::move(order));
+    }
+
+    using KeyTuple = std::tuple<std::string, OrderId>;
+
+    // Not sorted, with a missing key and a duplicate.
+    const std::vector<KeyTuple> ids = { { btc_market_id, 7 }, { btc_market_id, 100 }, { btc_market_id, 2 }, { "ETHUSDT", 2 }, { btc_market_id, 7 } };
+
+    std::vector<v5::Order> values;
+    std::vector<bool> found;
+
+    AWL_ASSERT_EQUAL(3u, storage.findMany(ids, values, found));
+
+    AWL_ASSERT(found == std::vector<bool>({ true, false, true, false, true }));
+
+    AWL_ASSERT(values[0] == orders[7]);
+    AWL_ASSERT(values[2] == orders[2]);
+    AWL_ASSERT(values[4] == orders[7]);
+}
+
+//--output all --filter SetFindManyBenchmark_Test --order_count 100000 --key_count 500
+AWL_TEST(SetFindManyBenchmark)
+{
+    AWL_ATTRIBUTE(size_t, order_count, 100);
+    AWL_ATTRIBUTE(size_t, key_count, 50);
+
+    DbContainer c(context);
+
+    auto storage = makeSet(c.m_db, "orders", std::make_tuple(&v5::Order::marketId, &v5::Order::id));
+
+    {
+        std::vector<v5::Order> orders;
+        orders.reserve(order_count);
+
+        for (size_t i = 0; i < order_count; ++i)
+        {
+            v5::Order order = makeSampleOrder5();
+
+            order.id = static_cast<OrderId>(i);
+
+            orders.push_back(std::move(order));
+        }
+
+        storage.insertBatch(orders);
+    }
+
+    using KeyTuple = std::tuple<std::string, OrderId>;
+
+    std::vector<KeyTuple> ids;
+    ids.reserve(order_count);
+
+    // Each key_count keys are looked up at once.
+    for (size_t i = 0; i < order_count; ++i)
+    {
+        ids.emplace_back(btc_market_id, static_cast<OrderId>((i * 7919) % order_count));
+    }
+
+    {
+        awl::StopWatch sw;
+
+        v5::Order order;
+
+        for (const KeyTuple& id : ids)
+        {
+            AWL_ASSERT(storage.find(id, order));
+        }
+
+        PrintSpeed(context, _T("find"), sw, order_count, _T("keys"));
+    }
+
+    {
+        awl::StopWatch sw;
+
+        std::vector<v5::Order> values;
+        std::vector<bool> found;
+
+        for (size_t i = 0; i < ids.size(); i += key_count)
+        {
+            const std::span<const KeyTuple> chunk(ids.data() + i, std::min(key_count, ids.size() - i));
+
+            AWL_ASSERT_EQUAL(chunk.size(), storage.findMany(chunk, values, found));
+        }
+
+        PrintSpeed(context, _T("findMany"), sw, order_count, _T("keys"));
+    }
+}
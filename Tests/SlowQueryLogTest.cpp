@@ -0,0 +1,140 @@
+#include "DbContainer.h"
+#include "ExchangeModel.h"
+#include "Tests/TableHelper.h"
+
+#include "SQLiteWrapper/Set.h"
+
+#include <string>
+#include <algorithm>
+#include <optional>
+#include <vector>
+
+using namespace swtest;
+using namespace exchange::data;
+
+AWL_TEST(SlowQueryLog)
+{
+    AWL_ATTRIBUTE(size_t, row_count, 100);
+
+    DbContainer c(context);
+
+    // All the executions are slow and all the tables are large.
+    c.m_db->enableSlowQueryLog(std::chrono::nanoseconds::zero(), 1);
+
+    auto set = makeSet(c.m_db, "markets", std::make_tuple(&Market::id));
+
+    for (size_t i = 0; i < row_count; ++i)
+    {
+        set.insert(Market{ {}, "m" + std::to_string(i), {} });
+    }
+
+    Market m;
+
+    AWL_ASSERT(set.find(std::make_tuple(std::string("m1")), m));
+    AWL_ASSERT(set.find(std::make_tuple(std::string("m2")), m));
+
+    size_t count = 0;
+
+    for ([[maybe_unused]] const Market& market : set)
+    {
+        ++count;
+    }
+
+    AWL_ASSERT_EQUAL(row_count, count);
+
+    const auto& entries = c.m_db->slowQueryLog()->entries();
+
+    // A query is logged once with the parameters of its first slow execution.
+    AWL_ASSERT_EQUAL(1, std::ranges::count_if(entries, [](const sqlite::SlowQueryLog::Entry& entry)
+    {
+        return entry.query.starts_with("INSERT");
+    }));
+
+    {
+        // The lookup uses the primary key.
+        auto select_i = std::ranges::find_if(entries, [](const sqlite::SlowQueryLog::Entry& entry)
+        {
+            return entry.query.find("WHERE") != std::string::npos && entry.query.starts_with("SELECT");
+        });
+
+        AWL_ASSERT(select_i != entries.end());
+        AWL_ASSERT(select_i->expandedQuery.find("'m1'") != std::string::npos);
+        AWL_ASSERT(select_i->largeScans.empty());
+    }
+
+    {
+        auto iterate_i = std::ranges::find_if(entries, [](const sqlite::SlowQueryLog::Entry& entry)
+        {
+            return entry.query.starts_with("SELECT") && entry.query.find("WHERE") == std::string::npos;
+        });
+
+        AWL_ASSERT(iterate_i != entries.end());
+        AWL_ASSERT(!iterate_i->plan.empty());
+        AWL_ASSERT(iterate_i->largeScans == std::vector<std::string>{ "markets" });
+    }
+}
+
+// The scans of the hand-written queries refer to the aliases of the tables.
+AWL_TEST(SlowQueryLogAlias)
+{
+    std::optional<Database> moved;
+
+    {
+        Database db(":memory:", *context.logger);
+
+        db.enableSlowQueryLog(std::chrono::nanoseconds::zero(), 10);
+
+        db.exec("CREATE TABLE orders (id INTEGER PRIMARY KEY, marketId TEXT, amount REAL);");
+        db.exec("CREATE TABLE markets (id TEXT PRIMARY KEY, name TEXT);");
+        db.exec("WITH RECURSIVE n(i) AS (SELECT 1 UNION ALL SELECT i + 1 FROM n WHERE i < 100) "
+            "INSERT INTO orders SELECT i, 'm' || (i % 5), i FROM n;");
+        db.exec("INSERT INTO markets VALUES ('m0', 'a'), ('m1', 'b');");
+
+        // The log is moved with the connection.
+        moved.emplace(std::move(db));
+    }
+
+    auto run = [&moved](const char* query)
+    {
+        Statement stmt(*moved, query);
+
+        stmt.setSlowQueryLog(moved->slowQueryLog());
+
+        while (stmt.Next())
+        {
+        }
+
+        stmt.reset();
+
+        return moved->slowQueryLog()->entries().back();
+    };
+
+    {
+        const sqlite::SlowQueryLog::Entry entry = run("SELECT o.id FROM orders o WHERE o.amount > 10;");
+
+        AWL_ASSERT(entry.largeScans == std::vector<std::string>{ "orders" });
+    }
+
+    {
+        // The small table is not flagged.
+        const sqlite::SlowQueryLog::Entry entry = run(
+            "SELECT o.id, m.name FROM markets AS m JOIN orders AS o ON o.marketId = m.id WHERE m.name <> 'x';");
+
+        AWL_ASSERT(entry.largeScans == std::vector<std::string>{ "orders" });
+        AWL_ASSERT(entry.unresolvedScans.empty());
+    }
+
+    {
+        const sqlite::SlowQueryLog::Entry entry = run("WITH big AS MATERIALIZED (SELECT amount FROM orders) SELECT sum(b.amount) FROM big b;");
+
+        AWL_ASSERT(entry.largeScans == std::vector<std::string>{ "orders" });
+        AWL_ASSERT(entry.unresolvedScans.empty());
+    }
+
+    {
+        const sqlite::SlowQueryLog::Entry entry = run("SELECT j.value FROM json_each('[1, 2]') j;");
+
+        AWL_ASSERT(entry.largeScans.empty());
+        AWL_ASSERT(entry.unresolvedScans.empty());
+    }
+}
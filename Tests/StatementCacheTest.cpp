@@ -0,0 +1,110 @@
+#include "DbContainer.h"
+#include "ExchangeModel.h"
+#include "Tests/TableHelper.h"
+
+#include "SQLiteWrapper/Set.h"
+#include "SQLiteWrapper/StatementCache.h"
+
+using namespace swtest;
+using namespace exchange::data;
+
+AWL_TEST(StatementCacheSet)
+{
+    DbContainer c(context);
+
+    sqlite::StatementCache& cache = c.db().statementCache();
+
+    {
+        auto set = makeSet(c.m_db, "markets", std::make_tuple(&Market::id));
+    }
+
+    const size_t idle_count = cache.size();
+
+    AWL_ASSERT(idle_count != 0u);
+
+    const size_t hit_count = cache.hitCount();
+    const size_t miss_count = cache.missCount();
+
+    // The statements of a short-lived set are taken from the cache.
+    {
+        auto set = makeSet(c.m_db, "markets", std::make_tuple(&Market::id));
+
+        AWL_ASSERT_EQUAL(0u, cache.size());
+
+        set.insert(Market{ {}, "abc", {} });
+
+        Market m;
+
+        AWL_ASSERT(set.find(std::string("abc"), m));
+    }
+
+    AWL_ASSERT_EQUAL(hit_count + idle_count, cache.hitCount());
+    AWL_ASSERT_EQUAL(miss_count, cache.missCount());
+    AWL_ASSERT_EQUAL(idle_count, cache.size());
+
+    c.db().invalidateScheme();
+
+    AWL_ASSERT_EQUAL(0u, cache.size());
+}
+
+AWL_TEST(StatementCacheCapacity)
+{
+    DbContainer c(context);
+
+    sqlite::StatementCache& cache = c.db().statementCache();
+
+    cache.setCapacity(1u);
+
+    {
+        auto set = makeSet(c.m_db, "markets", std::make_tuple(&Market::id));
+    }
+
+    AWL_ASSERT_EQUAL(1u, cache.size());
+
+    // The statements checked out before the cache is cleared are finalized when they are closed.
+    {
+        auto set = makeSet(c.m_db, "markets", std::make_tuple(&Market::id));
+
+        cache.clear();
+    }
+
+    AWL_ASSERT_EQUAL(0u, cache.size());
+}
+
+AWL_TEST(StatementCacheFlags)
+{
+    DbContainer c(context);
+
+    sqlite::StatementCache& cache = c.db().statementCache();
+
+    const std::string query = "SELECT 1;";
+
+    {
+        sqlite::Statement stmt;
+
+        stmt.openCached(c.db(), query, SQLITE_PREPARE_PERSISTENT);
+    }
+
+    AWL_ASSERT_EQUAL(1u, cache.size());
+
+    const size_t hit_count = cache.hitCount();
+
+    // The same SQL text with other prepare flags is a different statement.
+    {
+        sqlite::Statement stmt;
+
+        stmt.openCached(c.db(), query);
+
+        AWL_ASSERT_EQUAL(hit_count, cache.hitCount());
+    }
+
+    AWL_ASSERT_EQUAL(2u, cache.size());
+
+    {
+        sqlite::Statement stmt;
+
+        stmt.openCached(c.db(), query, SQLITE_PREPARE_PERSISTENT);
+
+        AWL_ASSERT_EQUAL(hit_count + 1u, cache.hitCount());
+    }
+}
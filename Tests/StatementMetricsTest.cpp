@@ -0,0 +1,100 @@
+#include "DbContainer.h"
+#include "ExchangeModel.h"
+#include "Tests/TableHelper.h"
+
+#include "SQLiteWrapper/Set.h"
+
+#include <string>
+
+using namespace swtest;
+using namespace exchange::data;
+
+namespace
+{
+    const sqlite::StatementMetrics* FindMetrics(sqlite::Database& db, const std::string& label)
+    {
+        for (const auto& [key, p_metrics] : db.metrics().entries())
+        {
+            if (p_metrics->label == label)
+            {
+                return p_metrics.get();
+            }
+        }
+
+        return nullptr;
+    }
+}
+
+AWL_TEST(StatementMetrics)
+{
+    DbContainer c(context);
+
+    {
+        // The metrics are disabled by default.
+        auto set = makeSet(c.m_db, "markets", std::make_tuple(&Market::id));
+
+        set.insert(Market{ {}, "m0", {} });
+
+        AWL_ASSERT(c.m_db->metrics().entries().empty());
+    }
+
+    c.m_db->enableMetrics();
+
+    auto set = makeSet(c.m_db, "markets", std::make_tuple(&Market::id));
+
+    for (size_t i = 1; i <= 3; ++i)
+    {
+        set.insert(Market{ {}, "m" + std::to_string(i), {} });
+    }
+
+    Market m;
+
+    AWL_ASSERT(set.find(std::make_tuple(std::string("m1")), m));
+    AWL_ASSERT(!set.find(std::make_tuple(std::string("m5")), m));
+
+    size_t count = 0;
+
+    for ([[maybe_unused]] const Market& market : set)
+    {
+        ++count;
+    }
+
+    AWL_ASSERT_EQUAL(4u, count);
+
+    {
+        const sqlite::StatementMetrics* p_insert = FindMetrics(*c.m_db, "insert");
+
+        AWL_ASSERT(p_insert != nullptr);
+        AWL_ASSERT_EQUAL(3u, p_insert->callCount);
+        AWL_ASSERT_EQUAL(3u, p_insert->stepCount);
+        AWL_ASSERT_EQUAL(0u, p_insert->rowCount);
+        AWL_ASSERT(p_insert->vmStepCount != 0u);
+        AWL_ASSERT(p_insert->maxStepTime <= p_insert->totalStepTime);
+
+        const sqlite::StatementMetrics* p_select = FindMetrics(*c.m_db, "select");
+
+        AWL_ASSERT(p_select != nullptr);
+        AWL_ASSERT_EQUAL(2u, p_select->callCount);
+        AWL_ASSERT_EQUAL(1u, p_select->rowCount);
+        AWL_ASSERT_EQUAL(0u, p_select->fullscanStepCount);
+
+        // SELECT without WHERE scans the table.
+        const sqlite::StatementMetrics* p_iterate = FindMetrics(*c.m_db, "iterate");
+
+        AWL_ASSERT(p_iterate != nullptr);
+        AWL_ASSERT_EQUAL(1u, p_iterate->callCount);
+        AWL_ASSERT_EQUAL(4u, p_iterate->rowCount);
+        AWL_ASSERT(p_iterate->fullscanStepCount != 0u);
+    }
+
+    const std::string json = c.m_db->metrics().json();
+
+    AWL_ASSERT(json.starts_with("[{") && json.ends_with("}]"));
+    AWL_ASSERT(json.find("\"label\":\"insert\",\"sql\":\"INSERT INTO markets") != std::string::npos);
+
+    context.logger->debug(awl::format() << "Statement metrics:\n" << c.m_db->metrics().text());
+
+    c.m_db->metrics().reset();
+
+    AWL_ASSERT_EQUAL(0u, FindMetrics(*c.m_db, "insert")->callCount);
+}
@@ -0,0 +1,252 @@
+#include "DbContainer.h"
+#include "ExchangeModel.h"
+#include "Tests/TableHelper.h"
+
+#include "SQLiteWrapper/Set.h"
+#include "SQLiteWrapper/SamplingProfiler.h"
+#include "SQLiteWrapper/TraceFile.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+using namespace swtest;
+using namespace exchange::data;
+
+namespace
+{
+    struct QuerySummary
+    {
+        std::string text;
+
+        std::vector<std::chrono::nanoseconds> durations;
+
+        std::chrono::nanoseconds total{};
+    };
+
+    std::map<uint64_t, QuerySummary> ReadTrace(const std::string& file_name)
+    {
+        std::ifstream in(file_name, std::ios::binary);
+
+        sqlite::readTraceHeader(in);
+
+        std::map<uint64_t, QuerySummary> summaries;
+
+        sqlite::TraceRecord record;
+
+        while (sqlite::readTraceRecord(in, record))
+        {
+            QuerySummary& summary = summaries[record.queryHash];
+
+            if (!record.text.empty())
+            {
+                summary.text = record.text;
+            }
+
+            summary.durations.push_back(record.duration);
+
+            summary.total += record.duration;
+        }
+
+        return summaries;
+    }
+
+    double ToMicroseconds(std::chrono::nanoseconds d)
+    {
+        return std::chrono::duration<double, std::micro>(d).count();
+    }
+
+    // Prints the queries ordered by the total time with the percentiles of their durations.
+    void PrintSummary(const awl::testing::TestContext& context, std::map<uint64_t, QuerySummary>& summaries)
+    {
+        std::vector<QuerySummary*> ordered;
+
+        for (auto& [hash, summary] : summaries)
+        {
+            std::ranges::sort(summary.durations);
+
+            ordered.push_back(&summary);
+        }
+
+        std::ranges::sort(ordered, [](const QuerySummary* a, const QuerySummary* b)
+        {
+            return a->total > b->total;
+        });
+
+        for (const QuerySummary* p_summary : ordered)
+        {
+            const std::vector<std::chrono::nanoseconds>& d = p_summary->durations;
+
+            auto percentile = [&d](size_t p)
+            {
+                return ToMicroseconds(d[(d.size() - 1) * p / 100]);
+            };
+
+            context.logger->debug(awl::format() << std::fixed << std::setprecision(1) <<
+                _T("count: ") << d.size() << _T(", total: ") << ToMicroseconds(p_summary->total) << _T("us") <<
+                _T(", p50: ") << percentile(50) << _T("us, p95: ") << percentile(95) << _T("us, p99: ") << percentile(99) <<
+                _T("us, max: ") << ToMicroseconds(d.back()) << _T("us, ") << p_summary->text);
+        }
+    }
+
+    // Profiles some inserts and lookups.
+    void MakeTrace(const awl::testing::TestContext& context, const std::string& file_name, size_t sample_interval, size_t row_count,
+        uint64_t& sample_count, uint64_t& dropped_count)
+    {
+        DbContainer c(context);
+
+        auto set = makeSet(c.m_db, "markets", std::make_tuple(&Market::id));
+
+        sqlite::SamplingProfiler profiler(c.db(), file_name, sample_interval);
+
+        for (size_t i = 0; i < row_count; ++i)
+        {
+            set.insert(Market{ {}, "m" + std::to_string(i), {} });
+        }
+
+        for (size_t i = 0; i < row_count; ++i)
+        {
+            Market m;
+
+            set.find(std::make_tuple("m" + std::to_string(i)), m);
+        }
+
+        profiler.stop();
+
+        sample_count = profiler.sampleCount();
+        dropped_count = profiler.droppedCount();
+    }
+}
+
+// The trace callback is moved with the connection.
+AWL_TEST(DatabaseTraceMove)
+{
+    size_t statement_count = 0;
+
+    std::optional<Database> db;
+
+    {
+        Database traced(":memory:", *context.logger);
+
+        traced.setTrace({ sqlite::TraceKind::Statement }, [&statement_count](const sqlite::TraceEvent& event)
+        {
+            AWL_ASSERT(event.kind == sqlite::TraceKind::Statement);
+
+            ++statement_count;
+        });
+
+        traced.exec("CREATE TABLE t (x INTEGER);");
+
+        AWL_ASSERT_EQUAL(1u, statement_count);
+
+        db.emplace(std::move(traced));
+    }
+
+    db->exec("INSERT INTO t VALUES (1);");
+
+    AWL_ASSERT_EQUAL(2u, statement_count);
+
+    Database other(":memory:", *context.logger);
+
+    other = std::move(*db);
+
+    db.reset();
+
+    other.exec("INSERT INTO t VALUES (2);");
+
+    AWL_ASSERT_EQUAL(3u, statement_count);
+}
+
+AWL_TEST(SamplingProfiler)
+{
+    AWL_ATTRIBUTE(size_t, row_count, 100);
+
+    const std::string file_name = "profile.trace";
+
+    uint64_t sample_count = 0;
+    uint64_t dropped_count = 0;
+
+    // Every second execution of 2 * row_count.
+    MakeTrace(context, file_name, 2, row_count, sample_count, dropped_count);
+
+    AWL_ASSERT_EQUAL(row_count, sample_count + dropped_count);
+
+    std::map<uint64_t, QuerySummary> summaries = ReadTrace(file_name);
+
+    size_t read_count = 0;
+
+    for (const auto& [hash, summary] : summaries)
+    {
+        AWL_ASSERT(summary.text.starts_with("INSERT") || summary.text.starts_with("SELECT"));
+
+        AWL_ASSERT_EQUAL(hash, sqlite::hashQuery(summary.text));
+
+        read_count += summary.durations.size();
+    }
+
+    AWL_ASSERT_EQUAL(sample_count, read_count);
+
+    std::filesystem::remove(file_name);
+}
+
+// The profiler does not remove a trace callback set after it.
+AWL_TEST(SamplingProfilerStop)
+{
+    const std::string file_name = "profile_stop.trace";
+
+    Database db(":memory:", *context.logger);
+
+    size_t statement_count = 0;
+
+    {
+        sqlite::SamplingProfiler profiler(db, file_name);
+
+        db.setTrace({ sqlite::TraceKind::Statement }, [&statement_count](const sqlite::TraceEvent&)
+        {
+            ++statement_count;
+        });
+
+        profiler.stop();
+    }
+
+    db.exec("CREATE TABLE t (x INTEGER);");
+
+    AWL_ASSERT_EQUAL(1u, statement_count);
+
+    std::filesystem::remove(file_name);
+}
+
+// Summarizes a trace written by SamplingProfiler, without a file it profiles a small workload.
+//--output all --filter TraceSummary_Test --trace_file profile.trace
+AWL_TEST(TraceSummary)
+{
+    AWL_ATTRIBUTE(awl::String, trace_file, _T(""));
+
+    std::string file_name = awl::toAString(trace_file);
+
+    const bool generated = file_name.empty();
+
+    if (generated)
+    {
+        file_name = "summary.trace";
+
+        uint64_t sample_count = 0;
+        uint64_t dropped_count = 0;
+
+        MakeTrace(context, file_name, 1, 100, sample_count, dropped_count);
+    }
+
+    std::map<uint64_t, QuerySummary> summaries = ReadTrace(file_name);
+
+    PrintSummary(context, summaries);
+
+    if (generated)
+    {
+        std::filesystem::remove(file_name);
+    }
+}